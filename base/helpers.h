@@ -31,6 +31,16 @@
 #define BASE_INTENTIONALLY_UNUSED(var) (void)var
 
 namespace base {
+// Hints the CPU to load the cache line containing address for reading. The
+// memory is not accessed, so the address does not need to be valid.
+inline void prefetch(const void* address) {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    BASE_INTENTIONALLY_UNUSED(address);
+#endif
+}
+
 class NONCOPYABLE {
    public:
     NONCOPYABLE() = default;
@@ -0,0 +1,134 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <thread>
+
+#include "threadpool.h"
+
+namespace base {
+// Ranges shorter than this are always sorted on the calling thread
+constexpr std::size_t PARALLEL_SORT_MIN_CHUNK = 1 << 15;
+
+/**
+ * @brief      Stable sorts a range using multiple threads
+ *
+ * The range is halved recursively until there is one part per thread or the
+ * parts get shorter than PARALLEL_SORT_MIN_CHUNK. Every part is sorted with
+ * std::stable_sort in its own thread and neighbouring parts are merged
+ * with std::inplace_merge afterwards, so the result is stable as well.
+ *
+ * @param[in]  first        Begin of range to sort
+ * @param[in]  last         End of range to sort
+ * @param[in]  comp         Comparison function, called from several threads
+ *                          at the same time
+ * @param[in]  threads      Maximum number of threads to use, 0 or 1 sorts on
+ *                          the calling thread only
+ *
+ * @tparam     RandomIt     Random access iterator type
+ * @tparam     Compare      Compare callable (lambda, std::function, functor...)
+ */
+template <class RandomIt, class Compare>
+void parallel_stable_sort(RandomIt first, RandomIt last, Compare comp,
+                          unsigned threads = std::thread::hardware_concurrency()) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    if (threads < 2 || length < 2 * PARALLEL_SORT_MIN_CHUNK) {
+        std::stable_sort(first, last, comp);
+        return;
+    }
+
+    RandomIt middle = first + length / 2;
+    unsigned leftThreads = threads / 2;
+    auto left = std::async(std::launch::async, [=]() { parallel_stable_sort(first, middle, comp, leftThreads); });
+    parallel_stable_sort(middle, last, comp, threads - leftThreads);
+    left.get();
+    std::inplace_merge(first, middle, last, comp);
+}
+
+/**
+ * @brief      Stable sorts a range using the threads of a pool
+ *
+ * Works like the variant above but runs the parts as tasks of pool instead of
+ * starting new threads. The calling thread helps while waiting.
+ *
+ * @param[in]  first        Begin of range to sort
+ * @param[in]  last         End of range to sort
+ * @param[in]  comp         Comparison function, called from several threads
+ *                          at the same time
+ * @param[in]  pool         Pool to run the parts in
+ * @param[in]  parts        Maximum number of parts sorted in parallel
+ *
+ * @tparam     RandomIt     Random access iterator type
+ * @tparam     Compare      Compare callable (lambda, std::function, functor...)
+ */
+template <class RandomIt, class Compare>
+void parallel_stable_sort(RandomIt first, RandomIt last, Compare comp, ThreadPool& pool, unsigned parts) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    if (parts < 2 || length < 2 * PARALLEL_SORT_MIN_CHUNK) {
+        std::stable_sort(first, last, comp);
+        return;
+    }
+
+    RandomIt middle = first + length / 2;
+    unsigned leftParts = parts / 2;
+    auto left = pool.submit([=, &pool]() { parallel_stable_sort(first, middle, comp, pool, leftParts); });
+    try {
+        parallel_stable_sort(middle, last, comp, pool, parts - leftParts);
+    } catch (...) {
+        // The left part must not work on the range anymore once we are gone
+        try {
+            pool.wait(left);
+        } catch (...) {
+        }
+        throw;
+    }
+    pool.wait(left);
+    std::inplace_merge(first, middle, last, comp);
+}
+
+template <class RandomIt, class Compare>
+void parallel_stable_sort(RandomIt first, RandomIt last, Compare comp, ThreadPool& pool) {
+    parallel_stable_sort(first, last, comp, pool, pool.size() + 1);
+}
+
+/**
+ * @brief      Stable sorts a range using multiple threads
+ *
+ * Uses default comparison function "smaller than".
+ *
+ * @param[in]  first        Begin of range to sort
+ * @param[in]  last         End of range to sort
+ *
+ * @tparam     RandomIt     Random access iterator type
+ */
+template <class RandomIt>
+void parallel_stable_sort(RandomIt first, RandomIt last) {
+    parallel_stable_sort(first, last, std::less<>());
+}
+}  // namespace base
@@ -0,0 +1,148 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "helpers.h"
+
+namespace base {
+/**
+ * @brief      Fixed number of worker threads processing a shared task queue
+ *
+ * Meant for fork/join style recursive algorithms: a task may submit subtasks
+ * and wait for them with wait(). While waiting, the calling thread runs other
+ * queued tasks instead of blocking, so waiting tasks can never starve the
+ * pool. A pool without worker threads runs all tasks inside wait().
+ *
+ * Workers take the oldest task, which is the largest one in a recursive
+ * algorithm. Waiting threads take the newest one, usually a subtask of their
+ * own, so tasks run nested on their stack never go deeper than the
+ * recursion itself would.
+ *
+ * The destructor finishes all queued tasks before joining the workers.
+ */
+class ThreadPool : public NONCOPYANDMOVEABLE {
+   public:
+    explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency())
+        : _workers(), _tasks(), _mutex(), _wakeup(), _stop(false) {
+        for (unsigned i = 0; i < threads; ++i) {
+            _workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wakeup.notify_all();
+        for (auto& worker : _workers) worker.join();
+    }
+
+    // Number of worker threads, not counting threads helping in wait()
+    unsigned size() const { return static_cast<unsigned>(_workers.size()); }
+
+    /**
+     * @brief      Queues a task for execution
+     *
+     * @param[in]  func     Callable without parameters
+     *
+     * @return     Future for the result of func, exceptions thrown by func
+     *             are rethrown by its get()
+     */
+    template <class Func>
+    std::future<std::invoke_result_t<Func>> submit(Func&& func) {
+        typedef std::invoke_result_t<Func> Result;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.emplace_back([task]() { (*task)(); });
+        }
+        _wakeup.notify_one();
+        return result;
+    }
+
+    /**
+     * @brief      Waits for a task and returns its result
+     *
+     * Runs other queued tasks while the awaited one is not finished yet.
+     *
+     * @param[in]  future   Future returned by submit()
+     */
+    template <class Result>
+    Result wait(std::future<Result>& future) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!runPendingTask()) future.wait_for(std::chrono::microseconds(100));
+        }
+        return future.get();
+    }
+
+    // Runs the most recently queued task on the calling thread, returns
+    // false if there was none
+    bool runPendingTask() {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_tasks.empty()) return false;
+            task = std::move(_tasks.back());
+            _tasks.pop_back();
+        }
+        task();
+        return true;
+    }
+
+   private:
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wakeup.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+                if (_tasks.empty()) return;
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    bool _stop;
+};
+}  // namespace base
@@ -0,0 +1,103 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <base/parallel_sort.h>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+std::vector<int> randomInts(std::size_t count, int maxValue) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, maxValue);
+    std::vector<int> values(count);
+    for (auto& value : values) value = randDist(randEngine);
+    return values;
+}
+}  // namespace
+
+TEST(ParallelSort, SmallVector_SortedAscending) {
+    std::vector<int> dut{5, 3, 9, 1, 1, 0, -4, 7};
+
+    base::parallel_stable_sort(dut.begin(), dut.end());
+
+    EXPECT_EQ((std::vector<int>{-4, 0, 1, 1, 3, 5, 7, 9}), dut);
+}
+
+TEST(ParallelSort, EmptyVector_NoThrow) {
+    std::vector<int> dut;
+
+    EXPECT_NO_THROW(base::parallel_stable_sort(dut.begin(), dut.end()));
+    EXPECT_TRUE(dut.empty());
+}
+
+TEST(ParallelSort, LargeVectorFourThreads_SameResultAsStdSort) {
+    std::vector<int> dut = randomInts(500000, 1000000);
+    std::vector<int> expected = dut;
+    std::sort(expected.begin(), expected.end());
+
+    base::parallel_stable_sort(dut.begin(), dut.end(), std::less<int>(), 4);
+
+    EXPECT_EQ(expected, dut);
+}
+
+TEST(ParallelSort, LargeVectorDescendingComparison_SortedDescending) {
+    std::vector<int> dut = randomInts(300000, 1000000);
+    std::vector<int> expected = dut;
+    std::sort(expected.begin(), expected.end(), [](int lhs, int rhs) { return lhs > rhs; });
+
+    base::parallel_stable_sort(
+        dut.begin(), dut.end(), [](int lhs, int rhs) { return lhs > rhs; }, 3);
+
+    EXPECT_EQ(expected, dut);
+}
+
+TEST(ParallelSort, LargeVectorManyDuplicates_OrderOfEqualElementsKept) {
+    std::vector<int> keys = randomInts(400000, 50);
+    std::vector<std::pair<int, int>> dut;
+    for (std::size_t i = 0; i < keys.size(); ++i) dut.emplace_back(keys[i], static_cast<int>(i));
+    auto byKey = [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) { return lhs.first < rhs.first; };
+    std::vector<std::pair<int, int>> expected = dut;
+    std::stable_sort(expected.begin(), expected.end(), byKey);
+
+    base::parallel_stable_sort(dut.begin(), dut.end(), byKey, 8);
+
+    EXPECT_EQ(expected, dut);
+}
+
+TEST(ParallelSort, LargeVectorThreadPool_SameResultAsStableSort) {
+    std::vector<int> keys = randomInts(300000, 100);
+    std::vector<std::pair<int, int>> dut;
+    for (std::size_t i = 0; i < keys.size(); ++i) dut.emplace_back(keys[i], static_cast<int>(i));
+    auto byKey = [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) { return lhs.first < rhs.first; };
+    std::vector<std::pair<int, int>> expected = dut;
+    std::stable_sort(expected.begin(), expected.end(), byKey);
+    base::ThreadPool pool(3);
+
+    base::parallel_stable_sort(dut.begin(), dut.end(), byKey, pool);
+
+    EXPECT_EQ(expected, dut);
+}
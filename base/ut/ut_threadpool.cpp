@@ -0,0 +1,109 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <base/threadpool.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Sums up [first, last) by splitting it recursively into pool tasks
+long long recursiveSum(base::ThreadPool& pool, int first, int last) {
+    if (last - first < 1000) {
+        long long sum = 0;
+        for (int i = first; i < last; ++i) sum += i;
+        return sum;
+    }
+
+    int middle = first + (last - first) / 2;
+    auto left = pool.submit([&pool, first, middle]() { return recursiveSum(pool, first, middle); });
+    long long right = recursiveSum(pool, middle, last);
+    return pool.wait(left) + right;
+}
+
+// Counts how many tasks are running nested on the stack of this thread
+thread_local int nestedTasks = 0;
+
+int maxNesting(base::ThreadPool& pool, int depth) {
+    ++nestedTasks;
+    int result = nestedTasks;
+    if (depth > 0) {
+        auto left = pool.submit([&pool, depth]() { return maxNesting(pool, depth - 1); });
+        result = std::max(result, maxNesting(pool, depth - 1));
+        result = std::max(result, pool.wait(left));
+    }
+    --nestedTasks;
+    return result;
+}
+}  // namespace
+
+TEST(ThreadPool, SubmitTasks_ResultsAvailableThroughFutures) {
+    base::ThreadPool pool(2);
+    std::vector<std::future<int>> results;
+
+    for (int i = 0; i < 100; ++i) results.push_back(pool.submit([i]() { return i * i; }));
+
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(i * i, pool.wait(results[i]));
+}
+
+TEST(ThreadPool, NoWorkerThreads_WaitRunsTasksItself) {
+    base::ThreadPool pool(0);
+    auto result = pool.submit([]() { return 42; });
+
+    EXPECT_EQ(0u, pool.size());
+    EXPECT_EQ(42, pool.wait(result));
+}
+
+TEST(ThreadPool, RecursiveTasksWaitingForSubtasks_NoDeadlock) {
+    base::ThreadPool pool(2);
+
+    EXPECT_EQ(499999500000LL, recursiveSum(pool, 0, 1000000));
+}
+
+TEST(ThreadPool, NoWorkerThreadsDeepRecursion_NestingBoundedByRecursionDepth) {
+    base::ThreadPool pool(0);
+
+    EXPECT_EQ(13, maxNesting(pool, 12));
+}
+
+TEST(ThreadPool, TaskThrows_ExceptionRethrownByWait) {
+    base::ThreadPool pool(1);
+    auto result = pool.submit([]() -> int { throw std::runtime_error("failed"); });
+
+    EXPECT_THROW(pool.wait(result), std::runtime_error);
+}
+
+TEST(ThreadPool, Destruction_FinishesQueuedTasks) {
+    std::atomic<int> done(0);
+    {
+        base::ThreadPool pool(1);
+        for (int i = 0; i < 50; ++i) pool.submit([&done]() { ++done; });
+    }
+
+    EXPECT_EQ(50, done.load());
+}
@@ -0,0 +1,455 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <base/argparser.h>
+#include <base/strings.h>
+#include <tree/tree.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+// Payload of exactly one cache line, ordered by its key only
+struct Record {
+    std::int64_t key;
+    char padding[56];
+
+    bool operator<(const Record& other) const { return key < other.key; }
+};
+static_assert(sizeof(Record) == 64, "Record is meant to fill one cache line");
+
+// Every payload is made from an unsigned rank. Keys handed to the container are
+// made from even ranks only, so an odd rank is a guaranteed miss.
+template <class T>
+struct Payload;
+
+template <>
+struct Payload<int> {
+    static const char* name() { return "int"; }
+    static int make(std::uint64_t rank) { return static_cast<int>(rank); }
+    static std::uint64_t hash(int item) { return static_cast<std::uint64_t>(item); }
+};
+
+template <>
+struct Payload<std::string> {
+    static const char* name() { return "string"; }
+    // Longer than the small string buffer and zero padded, so that string order
+    // matches rank order and the sorted distributions stay sorted
+    static std::string make(std::uint64_t rank) {
+        char digits[24];
+        std::snprintf(digits, sizeof(digits), "%012llu", static_cast<unsigned long long>(rank));
+        return std::string("a_long_common_prefix_for_all_keys_") + digits;
+    }
+    static std::uint64_t hash(const std::string& item) { return item.size() + item.back(); }
+};
+
+template <>
+struct Payload<Record> {
+    static const char* name() { return "struct64"; }
+    static Record make(std::uint64_t rank) {
+        Record record{static_cast<std::int64_t>(rank), {}};
+        record.padding[0] = static_cast<char>(rank);
+        return record;
+    }
+    static std::uint64_t hash(const Record& item) { return static_cast<std::uint64_t>(item.key) + item.padding[0]; }
+};
+
+// Thin adapters, so that every container runs exactly the same loops
+template <class Container>
+struct Adapter {
+    template <class T>
+    static bool find(const Container& container, const T& item) {
+        return container.find(item) != container.end();
+    }
+    template <class T>
+    static void erase(Container& container, const T& item) {
+        container.erase(container.find(item));
+    }
+};
+
+template <class T, class Compare, template <class> class Allocator, class Options>
+struct Adapter<base::Tree<T, Compare, Allocator, Options>> {
+    typedef base::Tree<T, Compare, Allocator, Options> Container;
+    static bool find(const Container& container, const T& item) { return container.contains(item); }
+    static void erase(Container& container, const T& item) { container.erase(container.find(item)); }
+};
+
+// Ranks in [0, 2^30), so that even int keys never overflow
+const std::uint64_t RANK_RANGE = std::uint64_t(1) << 30;
+
+// Zipf with s = 1 over at most ZIPF_UNIVERSE distinct ranks, drawn by inverting a
+// precomputed CDF. Popular ranks are scattered over the key range by a
+// multiplicative hash, so hot keys do not all sit in one corner of the tree.
+const std::size_t ZIPF_UNIVERSE = 1 << 20;
+
+std::vector<std::uint64_t> zipfRanks(std::size_t count, std::default_random_engine& engine) {
+    std::size_t universe = std::max<std::size_t>(1, std::min(count, ZIPF_UNIVERSE));
+    std::vector<double> cdf(universe);
+    double sum = 0.0;
+    for (std::size_t i = 0; i < universe; ++i) {
+        sum += 1.0 / static_cast<double>(i + 1);
+        cdf[i] = sum;
+    }
+    std::uniform_real_distribution<double> dist(0.0, sum);
+    std::vector<std::uint64_t> ranks(count);
+    for (auto& rank : ranks) {
+        std::size_t index = std::lower_bound(cdf.begin(), cdf.end(), dist(engine)) - cdf.begin();
+        rank = (std::min(index, universe - 1) * 0x9E3779B97F4A7C15ull) % RANK_RANGE;
+    }
+    return ranks;
+}
+
+// Returns count ranks, all even, following the named distribution
+std::vector<std::uint64_t> makeRanks(const std::string& distribution, std::size_t count, unsigned seed) {
+    std::default_random_engine engine(seed);
+    std::vector<std::uint64_t> ranks(count);
+    if (distribution == "uniform") {
+        std::uniform_int_distribution<std::uint64_t> dist(0, RANK_RANGE / 2 - 1);
+        for (auto& rank : ranks) rank = dist(engine);
+    } else if (distribution == "sorted") {
+        for (std::size_t i = 0; i < count; ++i) ranks[i] = i;
+    } else if (distribution == "reverse") {
+        for (std::size_t i = 0; i < count; ++i) ranks[i] = count - 1 - i;
+    } else if (distribution == "zipf") {
+        ranks = zipfRanks(count, engine);
+        for (auto& rank : ranks) rank /= 2;
+    } else if (distribution == "duplicates") {
+        // About a hundred copies of every distinct key
+        std::uniform_int_distribution<std::uint64_t> dist(0, std::max<std::size_t>(1, count / 100) - 1);
+        for (auto& rank : ranks) rank = dist(engine);
+    } else {
+        throw std::invalid_argument("Unknown distribution " + distribution);
+    }
+    for (auto& rank : ranks) rank *= 2;
+    return ranks;
+}
+
+struct Summary {
+    double mean;
+    double min;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+};
+
+Summary summarize(std::vector<double> samples) {
+    Summary summary{0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (samples.empty()) return summary;
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        return samples[static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1) + 0.5)];
+    };
+    for (double sample : samples) summary.mean += sample;
+    summary.mean /= static_cast<double>(samples.size());
+    summary.min = samples.front();
+    summary.p50 = percentile(0.5);
+    summary.p90 = percentile(0.9);
+    summary.p99 = percentile(0.99);
+    summary.max = samples.back();
+    return summary;
+}
+
+struct Result {
+    std::string container;
+    std::string payload;
+    std::string distribution;
+    std::size_t size;
+    std::string operation;
+    std::vector<double> nsPerOp;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+double nsPerOp(Clock::time_point start, Clock::time_point end, std::size_t ops) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) /
+           static_cast<double>(std::max<std::size_t>(ops, 1));
+}
+
+// Runs op(i) for all i < count in batches and records one ns/op sample per
+// batch. Batches keep the clock overhead out of the numbers and still give
+// enough samples for meaningful percentiles.
+template <class Op>
+void timeBatches(std::size_t count, std::vector<double>& samples, Op op) {
+    const std::size_t batchSize = std::min<std::size_t>(1000, std::max<std::size_t>(16, count / 100));
+    for (std::size_t first = 0; first < count; first += batchSize) {
+        std::size_t last = std::min(count, first + batchSize);
+        Clock::time_point start = Clock::now();
+        for (std::size_t i = first; i < last; ++i) op(i);
+        samples.push_back(nsPerOp(start, Clock::now(), last - first));
+    }
+}
+
+struct Config {
+    std::vector<std::size_t> sizes;
+    std::vector<std::string> distributions;
+    std::vector<std::string> payloads;
+    std::vector<std::string> containers;
+    std::vector<std::string> operations;
+    unsigned repeats;
+    unsigned seed;
+
+    bool runs(const std::string& operation) const {
+        return std::find(operations.begin(), operations.end(), operation) != operations.end();
+    }
+};
+
+// Runs all operations of one configuration repeats times and appends a result
+// per operation. Every repeat starts from a fresh container.
+template <class Container, class T>
+void runContainer(const std::string& containerName, const Config& config, const std::string& distribution,
+                  const std::vector<T>& items, const std::vector<T>& hits, const std::vector<T>& misses,
+                  std::vector<Result>& results, std::uint64_t& checksum) {
+    typedef Adapter<Container> Ops;
+    const char* operations[] = {"insert", "find_hit", "find_miss", "iterate", "erase", "clear", "bulk_build", "copy"};
+    std::vector<std::vector<double>> samples(std::size(operations));
+
+    for (unsigned repeat = 0; repeat < config.repeats; ++repeat) {
+        {
+            Container container;
+            timeBatches(items.size(), samples[0], [&](std::size_t i) { container.insert(items[i]); });
+            if (config.runs("find_hit")) {
+                timeBatches(hits.size(), samples[1], [&](std::size_t i) { checksum += Ops::find(container, hits[i]); });
+            }
+            if (config.runs("find_miss")) {
+                timeBatches(misses.size(), samples[2],
+                            [&](std::size_t i) { checksum += Ops::find(container, misses[i]); });
+            }
+            if (config.runs("iterate")) {
+                Clock::time_point start = Clock::now();
+                for (auto it = container.begin(); it != container.end(); ++it) checksum += Payload<T>::hash(*it);
+                samples[3].push_back(nsPerOp(start, Clock::now(), items.size()));
+            }
+            if (config.runs("erase")) {
+                timeBatches(hits.size(), samples[4], [&](std::size_t i) { Ops::erase(container, hits[i]); });
+                checksum += container.size();
+            }
+        }
+        if (config.runs("copy") || config.runs("clear")) {
+            Container container;
+            for (const auto& item : items) container.insert(item);
+            if (config.runs("copy")) {
+                Clock::time_point start = Clock::now();
+                Container copy(container);
+                samples[7].push_back(nsPerOp(start, Clock::now(), items.size()));
+                checksum += copy.size();
+            }
+            if (config.runs("clear")) {
+                Clock::time_point start = Clock::now();
+                container.clear();
+                samples[5].push_back(nsPerOp(start, Clock::now(), items.size()));
+            }
+        }
+        if (config.runs("bulk_build")) {
+            Clock::time_point start = Clock::now();
+            Container container(items.begin(), items.end());
+            samples[6].push_back(nsPerOp(start, Clock::now(), items.size()));
+            checksum += container.size();
+        }
+    }
+
+    for (std::size_t op = 0; op < samples.size(); ++op) {
+        if (!config.runs(operations[op])) continue;
+        results.push_back(
+            Result{containerName, Payload<T>::name(), distribution, items.size(), operations[op], samples[op]});
+        Summary summary = summarize(samples[op]);
+        std::cout << containerName << " " << Payload<T>::name() << " " << distribution << " n=" << items.size() << " "
+                  << operations[op] << ": " << summary.p50 << " ns/op (p90 " << summary.p90 << ", p99 " << summary.p99
+                  << ")" << std::endl;
+    }
+}
+
+template <class T>
+void runPayload(const Config& config, std::vector<Result>& results, std::uint64_t& checksum) {
+    for (auto size : config.sizes) {
+        for (const auto& distribution : config.distributions) {
+            std::vector<std::uint64_t> ranks = makeRanks(distribution, size, config.seed);
+            std::vector<T> items;
+            std::vector<T> hits;
+            std::vector<T> misses;
+            items.reserve(size);
+            hits.reserve(size);
+            misses.reserve(size);
+            for (auto rank : ranks) items.push_back(Payload<T>::make(rank));
+            // Hits look up (and erase) every inserted item once, in random order
+            std::shuffle(ranks.begin(), ranks.end(), std::default_random_engine(config.seed + 1));
+            for (auto rank : ranks) {
+                hits.push_back(Payload<T>::make(rank));
+                misses.push_back(Payload<T>::make(rank + 1));
+            }
+
+            for (const auto& container : config.containers) {
+                if (container == "tree") {
+                    runContainer<base::Tree<T>>(container, config, distribution, items, hits, misses, results,
+                                                checksum);
+                } else if (container == "slabtree") {
+                    runContainer<base::Tree<T, std::less<>, base::SlabNodeAllocator>>(
+                        container, config, distribution, items, hits, misses, results, checksum);
+                } else if (container == "multiset") {
+                    runContainer<std::multiset<T>>(container, config, distribution, items, hits, misses, results,
+                                                   checksum);
+                } else {
+                    throw std::invalid_argument("Unknown container " + container);
+                }
+            }
+        }
+    }
+}
+
+void writeJson(std::ostream& os, const Config& config, const std::vector<Result>& results) {
+    auto writeList = [&os](const auto& list) {
+        os << "[";
+        for (std::size_t i = 0; i < list.size(); ++i) os << (i ? ", " : "") << "\"" << list[i] << "\"";
+        os << "]";
+    };
+    os << "{\n  \"benchmark\": \"aelib_tree_benchmark\",\n  \"repeats\": " << config.repeats
+       << ",\n  \"seed\": " << config.seed << ",\n  \"distributions\": ";
+    writeList(config.distributions);
+    os << ",\n  \"payloads\": ";
+    writeList(config.payloads);
+    os << ",\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        Summary summary = summarize(result.nsPerOp);
+        os << (i ? "," : "") << "\n    {\"container\": \"" << result.container << "\", \"payload\": \""
+           << result.payload << "\", \"distribution\": \"" << result.distribution << "\", \"size\": " << result.size
+           << ", \"operation\": \"" << result.operation << "\", \"samples\": " << result.nsPerOp.size()
+           << ", \"ns_per_op\": {\"mean\": " << summary.mean << ", \"min\": " << summary.min
+           << ", \"p50\": " << summary.p50 << ", \"p90\": " << summary.p90 << ", \"p99\": " << summary.p99
+           << ", \"max\": " << summary.max << "}}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> entries;
+    for (auto& entry : base::split(list, ',')) {
+        if (!entry.empty()) entries.push_back(entry);
+    }
+    return entries;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    base::argparser parser("aelib_tree_benchmark");
+    parser.add_option<std::string>("sizes")
+        .short_option('n')
+        .long_option("sizes")
+        .description("Comma separated item counts, e.g. 1000,1000000,100000000")
+        .default_value(std::string("1000,10000,100000,1000000"));
+    parser.add_option<std::string>("distributions")
+        .short_option('d')
+        .long_option("distributions")
+        .description("Key distributions out of uniform,sorted,reverse,zipf,duplicates")
+        .default_value(std::string("uniform,sorted,reverse,zipf,duplicates"));
+    parser.add_option<std::string>("payloads")
+        .short_option('p')
+        .long_option("payloads")
+        .description("Payload types out of int,string,struct64")
+        .default_value(std::string("int,string,struct64"));
+    parser.add_option<std::string>("containers")
+        .short_option('c')
+        .long_option("containers")
+        .description("Containers out of tree,slabtree,multiset")
+        .default_value(std::string("tree,slabtree,multiset"));
+    parser.add_option<std::string>("operations")
+        .short_option('o')
+        .long_option("operations")
+        .description("Operations out of find_hit,find_miss,iterate,erase,clear,bulk_build,copy (insert always runs)")
+        .default_value(std::string("find_hit,find_miss,iterate,erase,clear,bulk_build,copy"));
+    parser.add_option<int>("repeats")
+        .short_option('r')
+        .long_option("repeats")
+        .description("Number of runs per configuration")
+        .default_value(5);
+    parser.add_option<int>("seed").long_option("seed").description("Seed for the key generator").default_value(42);
+    parser.add_option<std::string>("json").short_option('j').long_option("json").description(
+        "Write the results as JSON to this file");
+    parser.add_flag("help").short_option('h').long_option("help").description("Print this help");
+
+    auto args = parser.parse(argc, argv);
+    if (!args.success() || args.is_flag_set("help")) {
+        parser.print_help(std::cout, &args.get_errors());
+        return args.success() ? 0 : 1;
+    }
+
+    Config config;
+    try {
+        for (auto& size : splitList(args.get<std::string>("sizes"))) config.sizes.push_back(std::stoull(size));
+    } catch (const std::exception&) {
+        std::cerr << "Invalid list of sizes " << args.get<std::string>("sizes") << std::endl;
+        return 1;
+    }
+    config.distributions = splitList(args.get<std::string>("distributions"));
+    config.payloads = splitList(args.get<std::string>("payloads"));
+    config.containers = splitList(args.get<std::string>("containers"));
+    config.operations = splitList(args.get<std::string>("operations"));
+    config.operations.push_back("insert");
+    config.repeats = static_cast<unsigned>(std::max(1, args.get<int>("repeats")));
+    config.seed = static_cast<unsigned>(args.get<int>("seed"));
+
+    std::vector<Result> results;
+    std::uint64_t checksum = 0;
+    try {
+        for (const auto& payload : config.payloads) {
+            if (payload == "int") {
+                runPayload<int>(config, results, checksum);
+            } else if (payload == "string") {
+                runPayload<std::string>(config, results, checksum);
+            } else if (payload == "struct64") {
+                runPayload<Record>(config, results, checksum);
+            } else {
+                throw std::invalid_argument("Unknown payload " + payload);
+            }
+        }
+    } catch (const std::invalid_argument& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (args.has_option("json")) {
+        std::ofstream file(args.get<std::string>("json"));
+        writeJson(file, config, results);
+        if (!file) {
+            std::cerr << "Could not write " << args.get<std::string>("json") << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << results.size() << " results to " << args.get<std::string>("json") << std::endl;
+    }
+    std::cout << "(Checksum: " << checksum << ")" << std::endl;
+    return 0;
+}
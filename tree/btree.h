@@ -0,0 +1,609 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <base/helpers.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace base {
+template <class T, std::size_t NodeBytes, class Compare>
+class BTree;
+
+template <class T, std::size_t NodeBytes, class Compare>
+class BTreeIterator {
+    typedef typename BTree<T, NodeBytes, Compare>::LeafNode LeafNode;
+
+   public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    BTreeIterator() : _leaf(nullptr), _index(0) {}
+    BTreeIterator(const LeafNode* leaf, std::size_t index) : _leaf(leaf), _index(index) {}
+
+    const T& operator*() const {
+        if (_leaf == nullptr) throw std::out_of_range("Iterator reached end of container, no dereferencing possible");
+        return _leaf->items[_index];
+    }
+
+    const T* operator->() const { return &operator*(); }
+
+    bool operator==(const BTreeIterator& other) const { return _leaf == other._leaf && _index == other._index; }
+
+    bool operator!=(const BTreeIterator& other) const { return !operator==(other); }
+
+    const BTreeIterator& operator++() {
+        if (_leaf == nullptr) return *this;
+        if (++_index == _leaf->count) {
+            _leaf = _leaf->next;
+            _index = 0;
+        }
+        return *this;
+    }
+
+    const BTreeIterator& operator--() {
+        if (_leaf == nullptr) return *this;
+        if (_index > 0) {
+            --_index;
+        } else {
+            _leaf = _leaf->prev;
+            _index = (_leaf != nullptr) ? _leaf->count - 1 : 0;
+        }
+        return *this;
+    }
+
+    const BTreeIterator operator++(int) {
+        BTreeIterator temp(*this);
+        ++(*this);
+        return temp;
+    }
+
+    const BTreeIterator operator--(int) {
+        BTreeIterator temp(*this);
+        --(*this);
+        return temp;
+    }
+
+   private:
+    friend class BTree<T, NodeBytes, Compare>;
+
+    const LeafNode* _leaf;
+    std::size_t _index;
+};
+
+/**
+ * @brief      B+ tree storing many items per node
+ *
+ * An alternative to Tree when lookups are bound by memory latency: every
+ * node occupies about NodeBytes bytes, e.g. a few cache lines, and is
+ * searched in one go, so a lookup touches few nodes instead of one node per
+ * item on its path. All items are stored in the leaves, which are linked to
+ * iterate quickly. The inner nodes hold copies of items as separators.
+ *
+ * Like Tree it keeps items comparing equal in insertion order. Unlike Tree,
+ * insert() and erase() move items within and between nodes, so they
+ * invalidate all iterators except the one they return. T must be default constructible, copyable and
+ * movable.
+ */
+template <class T, std::size_t NodeBytes = 256, class Compare = std::less<>>
+class BTree : public NONCOPYANDMOVEABLE {
+   public:
+    typedef BTreeIterator<T, NodeBytes, Compare> iterator;
+    typedef Compare compare_type;
+
+    BTree() : _root(nullptr), _first(nullptr), _last(nullptr), _comp(), _size(0) {}
+    explicit BTree(Compare compare)
+        : _root(nullptr), _first(nullptr), _last(nullptr), _comp(std::move(compare)), _size(0) {}
+
+    ~BTree() { clear(); }
+
+    // Items comparing equal to existing ones are placed behind them
+    iterator insert(const T& item) { return emplace(item); }
+
+    iterator insert(T&& item) { return emplace(std::move(item)); }
+
+    template <class... Args>
+    iterator emplace(Args&&... args) {
+        T item(std::forward<Args>(args)...);
+        if (_root == nullptr) {
+            LeafNode* leaf = new LeafNode();
+            _root = leaf;
+            _first = leaf;
+            _last = leaf;
+        }
+
+        LeafNode* leaf = findLeaf(item, true);
+        std::size_t index = upperBoundIndex(leaf->items.data(), leaf->count, item);
+        if (leaf->count == LEAF_CAPACITY) {
+            LeafNode* right = splitLeaf(leaf);
+            if (index > leaf->count) {
+                index -= leaf->count;
+                leaf = right;
+            }
+        }
+        std::move_backward(leaf->items.begin() + index, leaf->items.begin() + leaf->count,
+                           leaf->items.begin() + leaf->count + 1);
+        leaf->items[index] = std::move(item);
+        ++leaf->count;
+        ++_size;
+        return iterator(leaf, index);
+    }
+
+    // Removes the item at position and returns an iterator to the item
+    // behind it, which is the only iterator still valid afterwards
+    iterator erase(iterator position) {
+        if (position._leaf == nullptr) return end();
+
+        LeafNode* leaf = const_cast<LeafNode*>(position._leaf);
+        std::size_t index = position._index;
+        std::move(leaf->items.begin() + index + 1, leaf->items.begin() + leaf->count, leaf->items.begin() + index);
+        --leaf->count;
+        --_size;
+        if (leaf == _root) {
+            if (leaf->count == 0) {
+                clear();
+                return end();
+            }
+        } else if (leaf->count < LEAF_CAPACITY / 2) {
+            rebalanceLeaf(leaf, index);
+        }
+        // The item behind the last one of a leaf starts the next leaf
+        if (index == leaf->count) return iterator(leaf->next, 0);
+        return iterator(leaf, index);
+    }
+
+    // Removes all items comparing equal to item and returns their number
+    std::size_t erase(const T& item) { return eraseEqual(item); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    std::size_t erase(const K& key) {
+        return eraseEqual(key);
+    }
+
+    // Returns the first item comparing equal to item
+    iterator find(const T& item) const { return findItem(item); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator find(const K& key) const {
+        return findItem(key);
+    }
+
+    bool contains(const T& item) const { return findItem(item) != end(); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    bool contains(const K& key) const {
+        return findItem(key) != end();
+    }
+
+    iterator begin() const { return (_first != nullptr) ? iterator(_first, 0) : end(); }
+
+    iterator end() const { return iterator(); }
+
+    std::size_t size() const { return _size; }
+
+    bool empty() const { return _size == 0; }
+
+    void clear() {
+        destroyNode(_root);
+        _root = nullptr;
+        _first = nullptr;
+        _last = nullptr;
+        _size = 0;
+    }
+
+    uint32_t getHeight() const {
+        uint32_t height = 0;
+        for (const Node* node = _root; node != nullptr; ++height) {
+            node = node->isLeaf ? nullptr : static_cast<const InnerNode*>(node)->children[0];
+        }
+        return height;
+    }
+
+#ifdef _AE_TREE_DEBUGMODE_
+    // Checks order, separators, fill levels, parent pointers and leaf links
+    bool checkStructure() const {
+        if (_root == nullptr) return _size == 0 && _first == nullptr && _last == nullptr;
+        std::size_t count = 0;
+        const LeafNode* previous = nullptr;
+        uint32_t leafDepth = 0;
+        if (_root->parent != nullptr) return false;
+        if (!checkNode(_root, nullptr, nullptr, 1, leafDepth, previous, count)) return false;
+        return previous == _last && _last->next == nullptr && count == _size;
+    }
+#endif
+
+    // The node headers take three or four pointers, nodes smaller than that
+    // fall back to the minimum capacity
+    static constexpr std::size_t LEAF_CAPACITY = std::max<std::size_t>(
+        4, (NodeBytes > 4 * sizeof(void*)) ? (NodeBytes - 4 * sizeof(void*)) / sizeof(T) : 0);
+    static constexpr std::size_t INNER_CAPACITY = std::max<std::size_t>(
+        4, (NodeBytes > 3 * sizeof(void*)) ? (NodeBytes - 3 * sizeof(void*)) / (sizeof(T) + sizeof(void*)) : 0);
+
+   private:
+    friend class BTreeIterator<T, NodeBytes, Compare>;
+
+    struct InnerNode;
+
+    struct Node {
+        explicit Node(bool leaf) : parent(nullptr), count(0), isLeaf(leaf) {}
+
+        InnerNode* parent;
+        // Number of items in a leaf or separators in an inner node
+        uint32_t count;
+        bool isLeaf;
+    };
+
+    struct LeafNode : Node {
+        LeafNode() : Node(true), prev(nullptr), next(nullptr), items() {}
+
+        LeafNode* prev;
+        LeafNode* next;
+        std::array<T, LEAF_CAPACITY> items;
+    };
+
+    // Every item below children[i] compares less or equal to keys[i] and
+    // every item below children[i + 1] greater or equal
+    struct InnerNode : Node {
+        InnerNode() : Node(false), keys(), children() {}
+
+        std::array<T, INNER_CAPACITY> keys;
+        std::array<Node*, INNER_CAPACITY + 1> children;
+    };
+
+    // Number of the first count items that are less than key, or with
+    // orEqual not greater than key. Small arithmetic items are counted
+    // without branches, which the compiler can vectorize. Others are
+    // binary searched to keep the number of comparisons low.
+    template <class K>
+    std::size_t countLess(const T* items, std::size_t count, const K& key, bool orEqual) const {
+        if constexpr (std::is_arithmetic_v<T>) {
+            std::size_t result = 0;
+            if (orEqual) {
+                for (std::size_t i = 0; i < count; ++i) result += !_comp(key, items[i]);
+            } else {
+                for (std::size_t i = 0; i < count; ++i) result += _comp(items[i], key);
+            }
+            return result;
+        } else {
+            if (orEqual) {
+                return std::upper_bound(items, items + count, key,
+                                        [this](const K& lhs, const T& rhs) { return _comp(lhs, rhs); }) -
+                       items;
+            }
+            return std::lower_bound(items, items + count, key,
+                                    [this](const T& lhs, const K& rhs) { return _comp(lhs, rhs); }) -
+                   items;
+        }
+    }
+
+    template <class K>
+    std::size_t lowerBoundIndex(const T* items, std::size_t count, const K& key) const {
+        return countLess(items, count, key, false);
+    }
+
+    std::size_t upperBoundIndex(const T* items, std::size_t count, const T& item) const {
+        return countLess(items, count, item, true);
+    }
+
+    // Leaf where key would be inserted behind the equal items (upper) or
+    // where the first item not less than key is searched
+    template <class K>
+    LeafNode* findLeaf(const K& key, bool upper) const {
+        Node* node = _root;
+        while (!node->isLeaf) {
+            InnerNode* inner = static_cast<InnerNode*>(node);
+            node = inner->children[countLess(inner->keys.data(), inner->count, key, upper)];
+        }
+        return static_cast<LeafNode*>(node);
+    }
+
+    template <class K>
+    iterator findItem(const K& key) const {
+        if (_root == nullptr) return end();
+
+        const LeafNode* leaf = findLeaf(key, false);
+        std::size_t index = lowerBoundIndex(leaf->items.data(), leaf->count, key);
+        // The first item not less than key may start the next leaf
+        if (index == leaf->count) {
+            leaf = leaf->next;
+            index = 0;
+            if (leaf == nullptr) return end();
+        }
+        if (_comp(key, leaf->items[index])) return end();
+        return iterator(leaf, index);
+    }
+
+    static std::size_t childIndex(const InnerNode* parent, const Node* child) {
+        std::size_t index = 0;
+        while (parent->children[index] != child) ++index;
+        return index;
+    }
+
+    static void setChild(InnerNode* parent, std::size_t index, Node* child) {
+        parent->children[index] = child;
+        child->parent = parent;
+    }
+
+    // Moves the upper half of the full leaf into a new leaf behind it
+    LeafNode* splitLeaf(LeafNode* leaf) {
+        LeafNode* right = new LeafNode();
+        std::size_t middle = LEAF_CAPACITY / 2;
+        std::move(leaf->items.begin() + middle, leaf->items.end(), right->items.begin());
+        right->count = LEAF_CAPACITY - middle;
+        leaf->count = middle;
+
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next != nullptr) {
+            leaf->next->prev = right;
+        } else {
+            _last = right;
+        }
+        leaf->next = right;
+
+        insertIntoParent(leaf, right->items[0], right);
+        return right;
+    }
+
+    // Adds right as new sibling behind left separated by key
+    void insertIntoParent(Node* left, const T& key, Node* right) {
+        InnerNode* parent = left->parent;
+        if (parent == nullptr) {
+            InnerNode* root = new InnerNode();
+            root->keys[0] = key;
+            setChild(root, 0, left);
+            setChild(root, 1, right);
+            root->count = 1;
+            _root = root;
+            return;
+        }
+
+        std::size_t index = childIndex(parent, left);
+        if (parent->count < INNER_CAPACITY) {
+            insertIntoInner(parent, index, key, right);
+            return;
+        }
+
+        // Split the full parent. Of all separators including the new one
+        // the middle one moves one level up, the others are shared evenly.
+        std::array<T, INNER_CAPACITY + 1> keys;
+        std::array<Node*, INNER_CAPACITY + 2> children;
+        std::move(parent->keys.begin(), parent->keys.begin() + index, keys.begin());
+        keys[index] = key;
+        std::move(parent->keys.begin() + index, parent->keys.end(), keys.begin() + index + 1);
+        std::copy(parent->children.begin(), parent->children.begin() + index + 1, children.begin());
+        children[index + 1] = right;
+        std::copy(parent->children.begin() + index + 1, parent->children.end(), children.begin() + index + 2);
+
+        std::size_t middle = INNER_CAPACITY / 2;
+        std::move(keys.begin(), keys.begin() + middle, parent->keys.begin());
+        for (std::size_t i = 0; i <= middle; ++i) setChild(parent, i, children[i]);
+        parent->count = middle;
+
+        InnerNode* sibling = new InnerNode();
+        std::move(keys.begin() + middle + 1, keys.end(), sibling->keys.begin());
+        for (std::size_t i = middle + 1; i < children.size(); ++i) setChild(sibling, i - middle - 1, children[i]);
+        sibling->count = INNER_CAPACITY - middle;
+
+        insertIntoParent(parent, keys[middle], sibling);
+    }
+
+    // Inserts key and right behind the child at index of a non full node
+    static void insertIntoInner(InnerNode* node, std::size_t index, const T& key, Node* right) {
+        std::move_backward(node->keys.begin() + index, node->keys.begin() + node->count,
+                           node->keys.begin() + node->count + 1);
+        std::move_backward(node->children.begin() + index + 1, node->children.begin() + node->count + 1,
+                           node->children.begin() + node->count + 2);
+        node->keys[index] = key;
+        setChild(node, index + 1, right);
+        ++node->count;
+    }
+
+    // Removes the separator at index and the child behind it
+    static void removeFromInner(InnerNode* node, std::size_t index) {
+        std::move(node->keys.begin() + index + 1, node->keys.begin() + node->count, node->keys.begin() + index);
+        std::move(node->children.begin() + index + 2, node->children.begin() + node->count + 1,
+                  node->children.begin() + index + 1);
+        --node->count;
+    }
+
+    template <class K>
+    std::size_t eraseEqual(const K& key) {
+        std::size_t erased = 0;
+        for (iterator it = findItem(key); it != end() && !_comp(key, *it); ++erased) it = erase(it);
+        return erased;
+    }
+
+    // Refills a leaf that became less than half full from a sibling or
+    // merges it with one. The position index in leaf, which may be one past
+    // its last item, is moved along with the items.
+    void rebalanceLeaf(LeafNode*& leaf, std::size_t& index) {
+        InnerNode* parent = leaf->parent;
+        std::size_t childPos = childIndex(parent, leaf);
+        LeafNode* left = (childPos > 0) ? static_cast<LeafNode*>(parent->children[childPos - 1]) : nullptr;
+        LeafNode* right =
+            (childPos < parent->count) ? static_cast<LeafNode*>(parent->children[childPos + 1]) : nullptr;
+
+        if (left != nullptr && left->count > LEAF_CAPACITY / 2) {
+            std::move_backward(leaf->items.begin(), leaf->items.begin() + leaf->count,
+                               leaf->items.begin() + leaf->count + 1);
+            leaf->items[0] = std::move(left->items[--left->count]);
+            ++leaf->count;
+            ++index;
+            parent->keys[childPos - 1] = leaf->items[0];
+        } else if (right != nullptr && right->count > LEAF_CAPACITY / 2) {
+            leaf->items[leaf->count++] = std::move(right->items[0]);
+            std::move(right->items.begin() + 1, right->items.begin() + right->count, right->items.begin());
+            --right->count;
+            parent->keys[childPos] = right->items[0];
+        } else if (left != nullptr) {
+            index += left->count;
+            mergeLeaves(left, leaf, childPos - 1);
+            leaf = left;
+        } else {
+            mergeLeaves(leaf, right, childPos);
+        }
+    }
+
+    // Moves all items of right into left and removes right with its
+    // separator at index
+    void mergeLeaves(LeafNode* left, LeafNode* right, std::size_t index) {
+        std::move(right->items.begin(), right->items.begin() + right->count, left->items.begin() + left->count);
+        left->count += right->count;
+        left->next = right->next;
+        if (right->next != nullptr) {
+            right->next->prev = left;
+        } else {
+            _last = left;
+        }
+
+        InnerNode* parent = left->parent;
+        removeFromInner(parent, index);
+        delete right;
+        rebalanceInner(parent);
+    }
+
+    void rebalanceInner(InnerNode* node) {
+        if (node == _root) {
+            if (node->count == 0) {
+                _root = node->children[0];
+                _root->parent = nullptr;
+                delete node;
+            }
+            return;
+        }
+        if (node->count >= INNER_CAPACITY / 2) return;
+
+        InnerNode* parent = node->parent;
+        std::size_t index = childIndex(parent, node);
+        InnerNode* left = (index > 0) ? static_cast<InnerNode*>(parent->children[index - 1]) : nullptr;
+        InnerNode* right = (index < parent->count) ? static_cast<InnerNode*>(parent->children[index + 1]) : nullptr;
+
+        if (left != nullptr && left->count > INNER_CAPACITY / 2) {
+            // Rotate the last child of left over the parent separator
+            std::move_backward(node->keys.begin(), node->keys.begin() + node->count,
+                               node->keys.begin() + node->count + 1);
+            std::move_backward(node->children.begin(), node->children.begin() + node->count + 1,
+                               node->children.begin() + node->count + 2);
+            node->keys[0] = std::move(parent->keys[index - 1]);
+            setChild(node, 0, left->children[left->count]);
+            ++node->count;
+            parent->keys[index - 1] = std::move(left->keys[--left->count]);
+        } else if (right != nullptr && right->count > INNER_CAPACITY / 2) {
+            // Rotate the first child of right over the parent separator
+            node->keys[node->count] = std::move(parent->keys[index]);
+            setChild(node, node->count + 1, right->children[0]);
+            ++node->count;
+            parent->keys[index] = std::move(right->keys[0]);
+            std::move(right->keys.begin() + 1, right->keys.begin() + right->count, right->keys.begin());
+            std::move(right->children.begin() + 1, right->children.begin() + right->count + 1,
+                      right->children.begin());
+            --right->count;
+        } else if (left != nullptr) {
+            mergeInner(left, node, index - 1);
+        } else {
+            mergeInner(node, right, index);
+        }
+    }
+
+    // Moves the parent separator at index and everything of right into
+    // left and removes right
+    void mergeInner(InnerNode* left, InnerNode* right, std::size_t index) {
+        InnerNode* parent = left->parent;
+        left->keys[left->count] = std::move(parent->keys[index]);
+        std::move(right->keys.begin(), right->keys.begin() + right->count, left->keys.begin() + left->count + 1);
+        for (std::size_t i = 0; i <= right->count; ++i) {
+            setChild(left, left->count + 1 + i, right->children[i]);
+        }
+        left->count += right->count + 1;
+
+        removeFromInner(parent, index);
+        delete right;
+        rebalanceInner(parent);
+    }
+
+    static void destroyNode(Node* node) {
+        if (node == nullptr) return;
+        if (node->isLeaf) {
+            delete static_cast<LeafNode*>(node);
+            return;
+        }
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        for (std::size_t i = 0; i <= inner->count; ++i) destroyNode(inner->children[i]);
+        delete inner;
+    }
+
+#ifdef _AE_TREE_DEBUGMODE_
+    // lower and upper are the separators around node, nullptr if none
+    bool checkNode(const Node* node, const T* lower, const T* upper, uint32_t depth, uint32_t& leafDepth,
+                   const LeafNode*& previous, std::size_t& count) const {
+        if (node != _root) {
+            std::size_t minimum = node->isLeaf ? LEAF_CAPACITY / 2 : INNER_CAPACITY / 2;
+            if (node->count < minimum) return false;
+        }
+        if (node->isLeaf) {
+            const LeafNode* leaf = static_cast<const LeafNode*>(node);
+            if (leafDepth == 0) leafDepth = depth;
+            if (depth != leafDepth || leaf->prev != previous) return false;
+            if (previous == nullptr ? _first != leaf : previous->next != leaf) return false;
+            for (std::size_t i = 0; i < leaf->count; ++i) {
+                if (i > 0 && _comp(leaf->items[i], leaf->items[i - 1])) return false;
+                if (lower != nullptr && _comp(leaf->items[i], *lower)) return false;
+                if (upper != nullptr && _comp(*upper, leaf->items[i])) return false;
+            }
+            previous = leaf;
+            count += leaf->count;
+            return true;
+        }
+
+        const InnerNode* inner = static_cast<const InnerNode*>(node);
+        for (std::size_t i = 0; i <= inner->count; ++i) {
+            if (inner->children[i]->parent != inner) return false;
+            const T* childLower = (i > 0) ? &inner->keys[i - 1] : lower;
+            const T* childUpper = (i < inner->count) ? &inner->keys[i] : upper;
+            if (!checkNode(inner->children[i], childLower, childUpper, depth + 1, leafDepth, previous, count))
+                return false;
+        }
+        return true;
+    }
+#endif
+
+    Node* _root;
+    LeafNode* _first;
+    LeafNode* _last;
+    Compare _comp;
+    std::size_t _size;
+};
+}  // namespace base
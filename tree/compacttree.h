@@ -0,0 +1,467 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace base {
+template <class T, class Compare>
+class CompactTree;
+
+template <class T, class Compare>
+class CompactIterator {
+   public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    CompactIterator() : _tree(nullptr), _current(CompactTree<T, Compare>::NIL) {}
+    CompactIterator(const CompactIterator& other) : _tree(other._tree), _current(other._current) {}
+    CompactIterator(const CompactTree<T, Compare>* tree, uint32_t current) : _tree(tree), _current(current) {}
+
+    const T& operator*() const {
+        if (_current == CompactTree<T, Compare>::NIL)
+            throw std::out_of_range("Iterator reached end of container, no dereferencing possible");
+        return _tree->_nodes[_current].payload;
+    }
+
+    const T* operator->() const { return &operator*(); }
+
+    const CompactIterator<T, Compare>& operator=(const CompactIterator<T, Compare>& other) {
+        _tree = other._tree;
+        _current = other._current;
+        return *this;
+    }
+
+    bool operator==(const CompactIterator<T, Compare>& other) const { return _current == other._current; }
+
+    bool operator!=(const CompactIterator<T, Compare>& other) const { return !operator==(other); }
+
+    const CompactIterator& operator++() {
+        if (_current != CompactTree<T, Compare>::NIL) _current = _tree->successor(_current);
+        return *this;
+    }
+
+    const CompactIterator& operator--() {
+        if (_current != CompactTree<T, Compare>::NIL) _current = _tree->predecessor(_current);
+        return *this;
+    }
+
+    const CompactIterator operator--(int) {
+        CompactIterator temp(*this);
+        --(*this);
+        return temp;
+    }
+
+    const CompactIterator operator++(int) {
+        CompactIterator temp(*this);
+        ++(*this);
+        return temp;
+    }
+
+    friend CompactTree<T, Compare>;
+
+   private:
+    const CompactTree<T, Compare>* _tree;
+    uint32_t _current;
+};
+
+// AVL tree with the same interface as base::Tree but a compact memory
+// layout. All nodes live in one contiguous vector and refer to each other
+// by 32 bit indices. Instead of a height every node only stores its balance
+// factor in two bits, which share a word with the parent index.
+//
+// For int payloads a node takes 16 bytes compared to 32 bytes of a
+// base::Node, so twice as many nodes fit into the cache while searching.
+//
+// The tree holds at most 2^30 - 1 elements. Erasing moves the last node of
+// the vector into the freed slot to keep the storage dense, which
+// invalidates iterators to the erased and to the last stored element.
+// Compare is used like the one of base::Tree.
+template <class T, class Compare = std::less<>>
+class CompactTree {
+   public:
+    typedef CompactIterator<T, Compare> iterator;
+    typedef Compare compare_type;
+
+    static constexpr uint32_t NIL = 0x3FFFFFFF;
+
+    struct CompactNode {
+        template <class... Args>
+        CompactNode(uint32_t parent, Args&&... args)
+            : payload(std::forward<Args>(args)...), left(NIL), right(NIL), parentAndBalance((parent << 2) | 1) {}
+
+        T payload;
+        uint32_t left;
+        uint32_t right;
+        // Upper 30 bits: index of parent, lower 2 bits: balance + 1
+        uint32_t parentAndBalance;
+    };
+
+    CompactTree() : _nodes(), _root(NIL), _comp() {}
+    explicit CompactTree(Compare compare) : _nodes(), _root(NIL), _comp(std::move(compare)) {}
+
+    // Sorted insertion of an item into the tree respecting the comparison
+    // function. Items comparing equal to existing ones are placed behind them.
+    iterator insert(const T& item) { return emplace(item); }
+
+    iterator insert(T&& item) { return emplace(std::move(item)); }
+
+    // Like insert() but constructs the item in place from args
+    template <class... Args>
+    iterator emplace(Args&&... args) {
+        if (_nodes.size() >= NIL) throw std::length_error("CompactTree cannot hold any more elements");
+
+        uint32_t insertee = static_cast<uint32_t>(_nodes.size());
+        _nodes.emplace_back(NIL, std::forward<Args>(args)...);
+        if (_root == NIL) {
+            _root = insertee;
+            return iterator(this, insertee);
+        }
+
+        const T& item = _nodes[insertee].payload;
+        uint32_t current = _root;
+        bool toLeft = false;
+        try {
+            while (true) {
+                toLeft = _comp(item, _nodes[current].payload);
+                uint32_t next = toLeft ? _nodes[current].left : _nodes[current].right;
+                if (next == NIL) break;
+                current = next;
+            }
+        } catch (...) {
+            _nodes.pop_back();
+            throw;
+        }
+
+        setParent(insertee, current);
+        if (toLeft) {
+            _nodes[current].left = insertee;
+        } else {
+            _nodes[current].right = insertee;
+        }
+        rebalanceAfterInsert(current, toLeft);
+        return iterator(this, insertee);
+    }
+
+    void erase(iterator position) {
+        uint32_t x = position._current;
+        if (x == NIL) return;
+
+        // A node with two children gets the payload of its in order
+        // successor, which is then removed instead.
+        if (_nodes[x].left != NIL && _nodes[x].right != NIL) {
+            uint32_t successor = leftMost(_nodes[x].right);
+            std::swap(_nodes[x].payload, _nodes[successor].payload);
+            x = successor;
+        }
+
+        uint32_t child = (_nodes[x].left != NIL) ? _nodes[x].left : _nodes[x].right;
+        uint32_t par = parent(x);
+        bool fromLeft = (par != NIL) && (_nodes[par].left == x);
+
+        if (child != NIL) setParent(child, par);
+        replaceChild(par, x, child);
+        rebalanceAfterErase(par, fromLeft);
+        removeSlot(x);
+    }
+
+    iterator find(const T& item) const { return iterator(this, findIndex(item)); }
+
+    // Heterogeneous lookup, only available for a transparent Compare
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator find(const K& key) const { return iterator(this, findIndex(key)); }
+
+    // Checks whether the provided item is contained inside the tree
+    bool contains(const T& item) const { return findIndex(item) != NIL; }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    bool contains(const K& key) const { return findIndex(key) != NIL; }
+
+    std::size_t size() const { return _nodes.size(); }
+
+    bool empty() const { return _nodes.empty(); }
+
+    void clear() {
+        _nodes.clear();
+        _root = NIL;
+    }
+
+    // Reserves storage for the given number of elements up front
+    void reserve(std::size_t capacity) { _nodes.reserve(capacity); }
+
+    iterator begin() const { return iterator(this, leftMost(_root)); }
+
+    iterator end() const { return iterator(this, NIL); }
+
+    // The height is not stored, so it is determined by following the
+    // heavier child of every node down to a leaf.
+    uint32_t getHeight() const {
+        uint32_t height = 0;
+        uint32_t current = _root;
+        while (current != NIL) {
+            ++height;
+            current = (balance(current) < 0) ? _nodes[current].left : _nodes[current].right;
+        }
+        return height;
+    }
+
+    int32_t getBalance() const { return (_root != NIL) ? balance(_root) : 0; }
+
+#ifdef _AE_TREE_DEBUGMODE_
+    // Checks links, order and stored balance factors of the whole tree
+    bool verifyStructure() const {
+        if (_root != NIL && parent(_root) != NIL) return false;
+        return recursiveVerifyStructure(_root) >= 0;
+    }
+#endif
+
+    friend CompactIterator<T, Compare>;
+
+   private:
+    CompactTree(const CompactTree&);
+
+    template <class K>
+    uint32_t findIndex(const K& item) const {
+        uint32_t current = _root;
+        while (current != NIL) {
+            const CompactNode& node = _nodes[current];
+            if (_comp(item, node.payload) == true) {
+                current = node.left;
+            } else if (_comp(node.payload, item) == true) {
+                current = node.right;
+            } else {
+                break;
+            }
+        }
+        return current;
+    }
+
+    uint32_t parent(uint32_t node) const { return _nodes[node].parentAndBalance >> 2; }
+
+    void setParent(uint32_t node, uint32_t par) {
+        _nodes[node].parentAndBalance = (par << 2) | (_nodes[node].parentAndBalance & 3);
+    }
+
+    int32_t balance(uint32_t node) const { return static_cast<int32_t>(_nodes[node].parentAndBalance & 3) - 1; }
+
+    void setBalance(uint32_t node, int32_t bal) {
+        _nodes[node].parentAndBalance = (_nodes[node].parentAndBalance & ~3u) | static_cast<uint32_t>(bal + 1);
+    }
+
+    uint32_t leftMost(uint32_t node) const {
+        if (node == NIL) return NIL;
+        while (_nodes[node].left != NIL) node = _nodes[node].left;
+        return node;
+    }
+
+    uint32_t rightMost(uint32_t node) const {
+        if (node == NIL) return NIL;
+        while (_nodes[node].right != NIL) node = _nodes[node].right;
+        return node;
+    }
+
+    uint32_t successor(uint32_t node) const {
+        if (_nodes[node].right != NIL) return leftMost(_nodes[node].right);
+
+        uint32_t par = parent(node);
+        while (par != NIL && _nodes[par].right == node) {
+            node = par;
+            par = parent(node);
+        }
+        return par;
+    }
+
+    uint32_t predecessor(uint32_t node) const {
+        if (_nodes[node].left != NIL) return rightMost(_nodes[node].left);
+
+        uint32_t par = parent(node);
+        while (par != NIL && _nodes[par].left == node) {
+            node = par;
+            par = parent(node);
+        }
+        return par;
+    }
+
+    // Lets the parent of oldChild (or the root) point to newChild instead
+    void replaceChild(uint32_t par, uint32_t oldChild, uint32_t newChild) {
+        if (par == NIL) {
+            _root = newChild;
+        } else if (_nodes[par].left == oldChild) {
+            _nodes[par].left = newChild;
+        } else {
+            _nodes[par].right = newChild;
+        }
+    }
+
+    void rotateLeft(uint32_t x) {
+        uint32_t z = _nodes[x].right;
+        uint32_t par = parent(x);
+        _nodes[x].right = _nodes[z].left;
+        if (_nodes[z].left != NIL) setParent(_nodes[z].left, x);
+        _nodes[z].left = x;
+        setParent(x, z);
+        setParent(z, par);
+        replaceChild(par, x, z);
+    }
+
+    void rotateRight(uint32_t x) {
+        uint32_t z = _nodes[x].left;
+        uint32_t par = parent(x);
+        _nodes[x].left = _nodes[z].right;
+        if (_nodes[z].right != NIL) setParent(_nodes[z].right, x);
+        _nodes[z].right = x;
+        setParent(x, z);
+        setParent(z, par);
+        replaceChild(par, x, z);
+    }
+
+    // Rebalances the subtree rooted at x whose balance would be bal (+2 or
+    // -2), which does not fit into the stored two bits. Returns whether the
+    // height of the subtree decreased by the rotation.
+    bool rotate(uint32_t x, int32_t bal) {
+        if (bal > 0) {
+            uint32_t z = _nodes[x].right;
+            int32_t zb = balance(z);
+            if (zb >= 0) {
+                rotateLeft(x);
+                setBalance(x, (zb == 0) ? 1 : 0);
+                setBalance(z, (zb == 0) ? -1 : 0);
+                return zb != 0;
+            }
+            uint32_t y = _nodes[z].left;
+            int32_t yb = balance(y);
+            rotateRight(z);
+            rotateLeft(x);
+            setBalance(x, (yb > 0) ? -1 : 0);
+            setBalance(z, (yb < 0) ? 1 : 0);
+            setBalance(y, 0);
+            return true;
+        } else {
+            uint32_t z = _nodes[x].left;
+            int32_t zb = balance(z);
+            if (zb <= 0) {
+                rotateRight(x);
+                setBalance(x, (zb == 0) ? -1 : 0);
+                setBalance(z, (zb == 0) ? 1 : 0);
+                return zb != 0;
+            }
+            uint32_t y = _nodes[z].right;
+            int32_t yb = balance(y);
+            rotateLeft(z);
+            rotateRight(x);
+            setBalance(z, (yb > 0) ? -1 : 0);
+            setBalance(x, (yb < 0) ? 1 : 0);
+            setBalance(y, 0);
+            return true;
+        }
+    }
+
+    // Retraces from the parent of a new leaf. Stops as soon as a subtree
+    // did not grow or after the first rotation.
+    void rebalanceAfterInsert(uint32_t node, bool grewLeft) {
+        while (node != NIL) {
+            int32_t bal = balance(node) + (grewLeft ? -1 : 1);
+            if (bal == 0) {
+                setBalance(node, 0);
+                return;
+            }
+            if (bal > 1 || bal < -1) {
+                rotate(node, bal);
+                return;
+            }
+            setBalance(node, bal);
+
+            uint32_t par = parent(node);
+            grewLeft = (par != NIL) && (_nodes[par].left == node);
+            node = par;
+        }
+    }
+
+    // Retraces from the parent of a removed node. Stops as soon as a
+    // subtree keeps its previous height.
+    void rebalanceAfterErase(uint32_t node, bool shrankLeft) {
+        while (node != NIL) {
+            uint32_t par = parent(node);
+            bool nodeIsLeft = (par != NIL) && (_nodes[par].left == node);
+
+            int32_t bal = balance(node) + (shrankLeft ? 1 : -1);
+            if (bal == 1 || bal == -1) {
+                setBalance(node, bal);
+                return;
+            }
+            if (bal == 0) {
+                setBalance(node, 0);
+            } else if (!rotate(node, bal)) {
+                return;
+            }
+
+            node = par;
+            shrankLeft = nodeIsLeft;
+        }
+    }
+
+    // Frees the slot of an unlinked node by moving the last node into it
+    void removeSlot(uint32_t slot) {
+        uint32_t last = static_cast<uint32_t>(_nodes.size() - 1);
+        if (slot != last) {
+            _nodes[slot] = std::move(_nodes[last]);
+            replaceChild(parent(slot), last, slot);
+            if (_nodes[slot].left != NIL) setParent(_nodes[slot].left, slot);
+            if (_nodes[slot].right != NIL) setParent(_nodes[slot].right, slot);
+        }
+        _nodes.pop_back();
+    }
+
+#ifdef _AE_TREE_DEBUGMODE_
+    int32_t recursiveVerifyStructure(uint32_t node) const {
+        if (node == NIL) return 0;
+
+        uint32_t lc = _nodes[node].left;
+        uint32_t rc = _nodes[node].right;
+        if (lc != NIL && (parent(lc) != node || _comp(_nodes[node].payload, _nodes[lc].payload))) return -1;
+        if (rc != NIL && (parent(rc) != node || _comp(_nodes[rc].payload, _nodes[node].payload))) return -1;
+
+        int32_t lh = recursiveVerifyStructure(lc);
+        int32_t rh = recursiveVerifyStructure(rc);
+        if (lh < 0 || rh < 0 || rh - lh != balance(node)) return -1;
+        return std::max(lh, rh) + 1;
+    }
+#endif
+
+    std::vector<CompactNode> _nodes;
+    uint32_t _root;
+    Compare _comp;
+};
+}  // namespace base
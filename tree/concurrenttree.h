@@ -0,0 +1,229 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <base/helpers.h>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "tree.h"
+
+namespace base {
+/**
+ * @brief      Counts the readers of one version of a ConcurrentTree
+ *
+ * The counter is split into stripes on separate cache lines. Every thread
+ * uses its own stripe, so readers on different cores do not write to the
+ * same cache line.
+ */
+class ReadIndicator : public NONCOPYANDMOVEABLE {
+   public:
+    ReadIndicator() : _stripes() {}
+
+    // Returns the stripe that has to be passed to depart()
+    std::size_t arrive() {
+        std::size_t stripe = threadStripe();
+        _stripes[stripe].readers.fetch_add(1);
+        return stripe;
+    }
+
+    void depart(std::size_t stripe) { _stripes[stripe].readers.fetch_sub(1); }
+
+    bool empty() const {
+        for (const Stripe& stripe : _stripes) {
+            if (stripe.readers.load() != 0) return false;
+        }
+        return true;
+    }
+
+   private:
+    static constexpr std::size_t NUM_OF_STRIPES = 16;
+
+    struct alignas(64) Stripe {
+        Stripe() : readers(0) {}
+        std::atomic<std::ptrdiff_t> readers;
+    };
+
+    // Threads get the stripes in round robin order when reading the first time
+    static std::size_t threadStripe() {
+        static std::atomic<std::size_t> nextStripe(0);
+        thread_local const std::size_t stripe = nextStripe.fetch_add(1) % NUM_OF_STRIPES;
+        return stripe;
+    }
+
+    Stripe _stripes[NUM_OF_STRIPES];
+};
+
+/**
+ * @brief      Tree that can be read by many threads while another one writes
+ *
+ * Uses the Left-Right technique: two instances of the tree with the same
+ * content are kept. Readers use the instance which is currently not written
+ * without taking a lock and without ever retrying. A writer first modifies
+ * the other instance, then points new readers to it, waits until all readers
+ * of the old instance are done and finally applies the same modification to
+ * the old instance.
+ *
+ * This doubles memory and write costs. Writers wait for readers that are
+ * still working on the previous instance, so keep ReadGuards short lived.
+ * Writes from several threads are serialized. TreeFeature::Statistics is not
+ * supported, lookups of concurrent readers would update the same counters.
+ */
+template <class T, class Compare = std::less<>, template <class> class Allocator = HeapNodeAllocator,
+          class Options = TreeOptions<>>
+class ConcurrentTree : public NONCOPYANDMOVEABLE {
+    static_assert(!Options::statistics, "ConcurrentTree readers would race on the counters of TreeFeature::Statistics");
+
+   public:
+    typedef Tree<T, Compare, Allocator, Options> tree_type;
+    typedef typename tree_type::iterator iterator;
+
+    /**
+     * @brief      Read access to a consistent state of the tree
+     *
+     * The tree and all iterators into it stay valid and unchanged as long as
+     * the guard lives, even while other threads write.
+     */
+    class ReadGuard : public NONCOPYANDMOVEABLE {
+       public:
+        explicit ReadGuard(const ConcurrentTree& owner)
+            : _readers(&owner._readers[owner._version.load()]),
+              _stripe(_readers->arrive()),
+              _tree(&owner.instance(owner._active.load())) {}
+
+        ~ReadGuard() { _readers->depart(_stripe); }
+
+        const tree_type& operator*() const { return *_tree; }
+        const tree_type* operator->() const { return _tree; }
+
+        iterator begin() const { return _tree->begin(); }
+        iterator end() const { return _tree->end(); }
+
+       private:
+        ReadIndicator* _readers;
+        std::size_t _stripe;
+        const tree_type* _tree;
+    };
+
+    ConcurrentTree() : _left(), _right(), _active(0), _version(0), _readers(), _writeMutex() {}
+    explicit ConcurrentTree(Compare compare)
+        : _left(compare), _right(compare), _active(0), _version(0), _readers(), _writeMutex() {}
+
+    ReadGuard read() const { return ReadGuard(*this); }
+
+    template <class K>
+    bool contains(const K& key) const {
+        return read()->contains(key);
+    }
+
+    std::size_t size() const { return read()->size(); }
+
+    bool empty() const { return read()->empty(); }
+
+    /**
+     * @brief      Applies a modification to the tree
+     *
+     * func is called once for each instance with a tree_type& and has to
+     * produce the same content both times. So it must not move nodes out of
+     * other trees (merge(), join()) or depend on state it changes itself.
+     * If func throws on the first call it must leave the tree unchanged, the
+     * second call must not throw at all.
+     */
+    template <class Func>
+    void modify(Func func) {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        std::size_t active = _active.load();
+        tree_type& next = instance(1 - active);
+        func(next);
+
+        _active.store(1 - active);
+        waitForReadersOfActive();
+
+        tree_type& previous = instance(active);
+        func(previous);
+    }
+
+    void insert(const T& item) {
+        modify([&item](tree_type& tree) { tree.insert(item); });
+    }
+
+    template <class InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void insert(InputIt first, InputIt last) {
+        typedef typename std::iterator_traits<InputIt>::iterator_category category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            modify([first, last](tree_type& tree) { tree.insert(first, last); });
+        } else {
+            // modify() walks the range once per instance, single pass input
+            // has to be buffered so that both instances see the same items
+            std::vector<T> items(first, last);
+            modify([&items](tree_type& tree) { tree.insert(items.begin(), items.end()); });
+        }
+    }
+
+    // Removes all items comparing equal to key and returns their number
+    template <class K>
+    std::size_t erase(const K& key) {
+        std::size_t erased = 0;
+        modify([&key, &erased](tree_type& tree) { erased = tree.erase(key); });
+        return erased;
+    }
+
+    void clear() {
+        modify([](tree_type& tree) { tree.clear(); });
+    }
+
+   private:
+    tree_type& instance(std::size_t index) { return (index == 0) ? _left : _right; }
+    const tree_type& instance(std::size_t index) const { return (index == 0) ? _left : _right; }
+
+    // Readers register for the current version before they look up the
+    // active instance. Toggling the version and waiting for both versions
+    // to drain ensures that no reader still uses the previously active one.
+    void waitForReadersOfActive() {
+        std::size_t previous = _version.load();
+        std::size_t next = 1 - previous;
+        waitUntilEmpty(_readers[next]);
+        _version.store(next);
+        waitUntilEmpty(_readers[previous]);
+    }
+
+    static void waitUntilEmpty(const ReadIndicator& readers) {
+        while (!readers.empty()) std::this_thread::yield();
+    }
+
+    tree_type _left;
+    tree_type _right;
+    std::atomic<std::size_t> _active;
+    std::atomic<std::size_t> _version;
+    mutable ReadIndicator _readers[2];
+    std::mutex _writeMutex;
+};
+}  // namespace base
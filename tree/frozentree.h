@@ -0,0 +1,224 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <base/helpers.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace base {
+template <class T, class Compare>
+class FrozenTree;
+
+template <class T, class Compare>
+class FrozenIterator {
+   public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    FrozenIterator() : _tree(nullptr), _index(0) {}
+    FrozenIterator(const FrozenTree<T, Compare>* tree, std::size_t index) : _tree(tree), _index(index) {}
+
+    const T& operator*() const {
+        if (_index == 0) throw std::out_of_range("Iterator reached end of container, no dereferencing possible");
+        return _tree->_items[_index - 1];
+    }
+
+    const T* operator->() const { return &operator*(); }
+
+    bool operator==(const FrozenIterator& other) const { return _index == other._index; }
+
+    bool operator!=(const FrozenIterator& other) const { return !operator==(other); }
+
+    const FrozenIterator& operator++() {
+        if (_index != 0) _index = _tree->successor(_index);
+        return *this;
+    }
+
+    const FrozenIterator& operator--() {
+        if (_index != 0) _index = _tree->predecessor(_index);
+        return *this;
+    }
+
+    const FrozenIterator operator++(int) {
+        FrozenIterator temp(*this);
+        ++(*this);
+        return temp;
+    }
+
+    const FrozenIterator operator--(int) {
+        FrozenIterator temp(*this);
+        --(*this);
+        return temp;
+    }
+
+   private:
+    const FrozenTree<T, Compare>* _tree;
+    // Position in the implicit tree starting with 1 at the root, 0 is end
+    std::size_t _index;
+};
+
+/**
+ * @brief      Immutable sorted set of items in Eytzinger layout
+ *
+ * The items form an implicit, complete binary search tree stored in breadth
+ * first order: the children of the item at position k are at 2k and 2k + 1.
+ * The top levels of the tree, which every lookup passes, share a few cache
+ * lines. A lookup only computes the next position, without branches, and
+ * prefetches the cache line holding the 16 descendants four levels further
+ * down, so several levels of memory accesses overlap.
+ *
+ * Created by Tree::freeze() or from any range. Iterating is slower than for
+ * a sorted array, as the successor of an item is not its neighbour.
+ */
+template <class T, class Compare = std::less<>>
+class FrozenTree {
+   public:
+    typedef FrozenIterator<T, Compare> iterator;
+    typedef Compare compare_type;
+
+    FrozenTree() : _items(), _comp() {}
+
+    // Items comparing equal keep their order in [first, last)
+    template <class InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    FrozenTree(InputIt first, InputIt last, Compare compare = Compare()) : _items(), _comp(std::move(compare)) {
+        std::vector<T> sorted(first, last);
+        if (!std::is_sorted(sorted.begin(), sorted.end(), _comp)) {
+            std::stable_sort(sorted.begin(), sorted.end(), _comp);
+        }
+        // The items are moved into place in breadth first order, so T needs
+        // neither a default constructor nor a copy per position
+        std::vector<std::size_t> sources(sorted.size());
+        std::size_t next = 0;
+        fillSources(sources, next, 1);
+        _items.reserve(sorted.size());
+        for (std::size_t source : sources) _items.push_back(std::move(sorted[source]));
+    }
+
+    // First item not less than key
+    template <class K>
+    iterator lower_bound(const K& key) const {
+        return iterator(this, lowerBoundIndex(key));
+    }
+
+    // First item comparing equal to key
+    template <class K>
+    iterator find(const K& key) const {
+        std::size_t index = lowerBoundIndex(key);
+        if (index == 0 || _comp(key, _items[index - 1])) return end();
+        return iterator(this, index);
+    }
+
+    template <class K>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    iterator begin() const {
+        if (_items.empty()) return end();
+        std::size_t index = 1;
+        while (2 * index <= _items.size()) index *= 2;
+        return iterator(this, index);
+    }
+
+    iterator end() const { return iterator(this, 0); }
+
+    std::size_t size() const { return _items.size(); }
+
+    bool empty() const { return _items.empty(); }
+
+   private:
+    friend class FrozenIterator<T, Compare>;
+
+    // In order traversal of the implicit tree assigning every position the
+    // index of its item in the sorted input
+    static void fillSources(std::vector<std::size_t>& sources, std::size_t& next, std::size_t index) {
+        if (index > sources.size()) return;
+        fillSources(sources, next, 2 * index);
+        sources[index - 1] = next++;
+        fillSources(sources, next, 2 * index + 1);
+    }
+
+    template <class K>
+    std::size_t lowerBoundIndex(const K& key) const {
+        const std::size_t count = _items.size();
+        const T* items = _items.data();
+        std::size_t index = 1;
+        while (index <= count) {
+            // Address arithmetic instead of pointers, positions beyond the
+            // end are fine for a prefetch
+            prefetch(reinterpret_cast<const void*>(reinterpret_cast<std::uintptr_t>(items) +
+                                                   (16 * index - 1) * sizeof(T)));
+            index = 2 * index + static_cast<std::size_t>(_comp(items[index - 1], key));
+        }
+        // The path went right for every item less than key. Undoing the
+        // last right turns and the final left turn leads to the result.
+        return index >> (trailingOnes(index) + 1);
+    }
+
+    static unsigned trailingOnes(std::size_t value) {
+#if defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_ctzll(~static_cast<unsigned long long>(value)));
+#else
+        unsigned count = 0;
+        for (; value & 1; value >>= 1) ++count;
+        return count;
+#endif
+    }
+
+    // Leftmost item in the right subtree or the first ancestor reached
+    // from a left subtree
+    std::size_t successor(std::size_t index) const {
+        if (2 * index + 1 <= _items.size()) {
+            index = 2 * index + 1;
+            while (2 * index <= _items.size()) index *= 2;
+            return index;
+        }
+        return index >> (trailingOnes(index) + 1);
+    }
+
+    std::size_t predecessor(std::size_t index) const {
+        if (2 * index <= _items.size()) {
+            index = 2 * index;
+            while (2 * index + 1 <= _items.size()) index = 2 * index + 1;
+            return index;
+        }
+        while (index != 0 && (index & 1) == 0) index >>= 1;
+        return index >> 1;
+    }
+
+    std::vector<T> _items;
+    Compare _comp;
+};
+}  // namespace base
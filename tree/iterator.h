@@ -24,35 +24,45 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <stdexcept>
 
 #include "node.h"
 
 namespace base {
-template <class T>
+template <class T, class Compare, template <class> class Allocator, class Options>
 class Tree;
 
-template <class T>
+template <class T, class Options = TreeOptions<>>
 class Iterator {
    public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
     Iterator() : _current(nullptr) {}
     Iterator(const Iterator& other) : _current(other._current) {}
-    Iterator(Node<T>* current) : _current(current) {}
+    Iterator(Node<T, Options>* current) : _current(current) {}
 
-    const T operator*() const {
+    const T& operator*() const {
         if (_current == nullptr)
             throw std::out_of_range("Iterator reached end of container, no dereferencing possible");
-        return (const T)_current->getPayload();
+        return _current->getPayload();
     }
 
-    const Iterator<T>& operator=(const Iterator<T>& other) {
+    const T* operator->() const { return &operator*(); }
+
+    const Iterator<T, Options>& operator=(const Iterator<T, Options>& other) {
         _current = other._current;
         return *this;
     }
 
-    bool operator==(const Iterator<T>& other) const { return _current == other._current; }
+    bool operator==(const Iterator<T, Options>& other) const { return _current == other._current; }
 
-    bool operator!=(const Iterator<T>& other) const { return !operator==(other); }
+    bool operator!=(const Iterator<T, Options>& other) const { return !operator==(other); }
 
     const Iterator& operator++() {
         // If we are already beyond the end do nothing.
@@ -60,6 +70,11 @@ class Iterator {
             return *this;
         }
 
+        if constexpr (Options::threaded) {
+            _current = _current->getNext();
+            return *this;
+        }
+
         // If the current node has a right child, then this is always
         // the correct node to go to next and traverse it to the leftmost
         // child and leave the increment function
@@ -69,7 +84,7 @@ class Iterator {
         }
 
         while (true) {
-            Node<T>* parent = _current->getParent();
+            Node<T, Options>* parent = _current->getParent();
             // If there is no parent (and no right child) we are done iterating.
             // Set iterator beyond end
             if (parent == nullptr) {
@@ -94,6 +109,11 @@ class Iterator {
             return *this;
         }
 
+        if constexpr (Options::threaded) {
+            _current = _current->getPrev();
+            return *this;
+        }
+
         // If the current node has a left child, then this is always
         // the correct node to go to next and traverse it to the rightmost
         // child and leave the increment function
@@ -103,7 +123,7 @@ class Iterator {
         }
 
         while (true) {
-            Node<T>* parent = _current->getParent();
+            Node<T, Options>* parent = _current->getParent();
             // If there is no parent (and no left child) we are done iterating.
             // Set iterator beyond end
             if (parent == nullptr) {
@@ -134,9 +154,30 @@ class Iterator {
         return temp;
     }
 
-    friend Tree<T>;
+    template <class, class, template <class> class, class>
+    friend class Tree;
+
+   private:
+    Node<T, Options>* _current;
+};
+
+// Lazy view on the half open range [first, last) of a container. Nothing
+// is copied, iterating the view just walks the underlying iterators.
+template <class It>
+class IteratorRange {
+   public:
+    typedef It iterator;
+
+    IteratorRange(It first, It last) : _first(first), _last(last) {}
+
+    It begin() const { return _first; }
+
+    It end() const { return _last; }
+
+    bool empty() const { return _first == _last; }
 
    private:
-    Node<T>* _current;
+    It _first;
+    It _last;
 };
 }  // namespace base
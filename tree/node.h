@@ -25,44 +25,90 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <utility>
+
+#include "treeoptions.h"
 
 namespace base {
-template <class T>
-class Node {
+// Storage of the optional node augmentations. The empty specializations
+// are folded away as empty base classes. The subtree size is as wide as
+// std::size_t, so order statistics stay exact beyond 2^32 items.
+template <bool Enabled>
+class SubtreeSizeField {
+   protected:
+    std::size_t _subtreeSize = 1;
+};
+
+template <>
+class SubtreeSizeField<false> {};
+
+template <bool Enabled, class NodeT>
+class ThreadLinksField {
+   protected:
+    NodeT* _prev = nullptr;
+    NodeT* _next = nullptr;
+};
+
+template <class NodeT>
+class ThreadLinksField<false, NodeT> {};
+
+template <class T, class Options = TreeOptions<>>
+class Node : private SubtreeSizeField<Options::subtreeSize>,
+             private ThreadLinksField<Options::threaded, Node<T, Options>> {
    public:
-    Node(Node<T>* parent, T payload)
-        : _parent(parent), _left(nullptr), _right(nullptr), _payload(payload), _height(1) {}
+    // Constructs the payload in place from args
+    template <class... Args>
+    Node(Node* parent, Args&&... args)
+        : _parent(parent), _left(nullptr), _right(nullptr), _payload(std::forward<Args>(args)...), _height(1) {}
 
-    Node<T>* getParent() { return _parent; }
+    Node* getParent() { return _parent; }
 
-    Node<T>* getLeftChild() { return _left; }
+    Node* getLeftChild() { return _left; }
 
-    Node<T>* getRightChild() { return _right; }
+    Node* getRightChild() { return _right; }
 
-    void setLeftChild(Node<T>* node) {
+    void setLeftChild(Node* node) {
         _left = node;
-        updateHeight();
+        updateMetaData();
     }
 
-    void setRightChild(Node<T>* node) {
+    void setRightChild(Node* node) {
         _right = node;
-        updateHeight();
+        updateMetaData();
+    }
+
+    // Replaces both children at once, updating the meta data only once
+    void setChildren(Node* left, Node* right) {
+        _left = left;
+        _right = right;
+        updateMetaData();
     }
 
-    void setParent(Node<T>* node) { _parent = node; }
+    void setParent(Node* node) { _parent = node; }
 
-    void updateHeight() {
+    // Recalculates height and all enabled augmentations from the children
+    void updateMetaData() {
         uint32_t lh = 0;
         uint32_t rh = 0;
         if (_left != nullptr) lh = _left->getHeight();
         if (_right != nullptr) rh = _right->getHeight();
 
         _height = std::max<uint32_t>(lh, rh) + 1;
+
+        if constexpr (Options::subtreeSize) {
+            this->_subtreeSize = getSubtreeSize(_left) + getSubtreeSize(_right) + 1;
+        }
     }
 
     uint32_t getHeight() { return _height; }
 
+    // Overrides the height calculated by updateMetaData(). Only needed by
+    // rank balanced policies like WavlBalance, whose ranks may exceed the
+    // height and must survive relinking the children.
+    void setHeight(uint32_t height) { _height = height; }
+
     int32_t getBalance() {
         uint32_t lh = 0;
         uint32_t rh = 0;
@@ -71,28 +117,63 @@ class Node {
         return rh - lh;
     }
 
-    void swapPayload(Node<T>* other) { std::swap(_payload, other->_payload); }
+    // Number of nodes in the subtree below and including this node.
+    // Only available with TreeFeature::SubtreeSize.
+    std::size_t getSubtreeSize() const {
+        static_assert(Options::subtreeSize, "Node does not store the subtree size, enable TreeFeature::SubtreeSize");
+        return this->_subtreeSize;
+    }
+
+    static std::size_t getSubtreeSize(const Node* node) { return (node != nullptr) ? node->getSubtreeSize() : 0; }
+
+    // Adjusts the subtree size by delta without looking at the children.
+    // Used to update the ancestors of an inserted or erased node.
+    void adjustSubtreeSize(int32_t delta) {
+        static_assert(Options::subtreeSize, "Node does not store the subtree size, enable TreeFeature::SubtreeSize");
+        this->_subtreeSize += static_cast<std::size_t>(delta);
+    }
+
+    // In-order neighbours, nullptr at both ends of the sequence.
+    // Only available with TreeFeature::Threaded.
+    Node* getPrev() {
+        static_assert(Options::threaded, "Node does not store thread links, enable TreeFeature::Threaded");
+        return this->_prev;
+    }
+
+    Node* getNext() {
+        static_assert(Options::threaded, "Node does not store thread links, enable TreeFeature::Threaded");
+        return this->_next;
+    }
+
+    // Links left and right as neighbours, either of them may be nullptr
+    static void linkThread(Node* left, Node* right) {
+        static_assert(Options::threaded, "Node does not store thread links, enable TreeFeature::Threaded");
+        if (left != nullptr) left->_next = right;
+        if (right != nullptr) right->_prev = left;
+    }
 
     void makeRoot() { _parent = nullptr; }
 
     bool isRoot() { return _parent == nullptr; }
 
-    T getPayload() { return _payload; }
+    T& getPayload() { return _payload; }
+
+    const T& getPayload() const { return _payload; }
 
    private:
     Node();
-    Node(const Node<T>&);
+    Node(const Node&);
 
-    Node<T>* _parent;
-    Node<T>* _left;
-    Node<T>* _right;
+    Node* _parent;
+    Node* _left;
+    Node* _right;
     T _payload;
 
     uint32_t _height;
 };
 
-template <class T>
-static Node<T>* getLeftMostNode(Node<T>* old) {
+template <class NodeT>
+static NodeT* getLeftMostNode(NodeT* old) {
     if (old == nullptr) return nullptr;
 
     while (old->getLeftChild() != nullptr) {
@@ -102,8 +183,8 @@ static Node<T>* getLeftMostNode(Node<T>* old) {
     return old;
 }
 
-template <class T>
-static Node<T>* getRightMostNode(Node<T>* old) {
+template <class NodeT>
+static NodeT* getRightMostNode(NodeT* old) {
     if (old == nullptr) return nullptr;
 
     while (old->getRightChild() != nullptr) {
@@ -0,0 +1,353 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <base/helpers.h>
+#include <base/threadpool.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Node allocation policies for base::Tree.
+//
+// A policy is a class template over the node type and has to offer:
+//  * create(args...)  - Allocates and constructs a single node
+//  * destroy(node)    - Destructs and frees a single node
+//  * destroyAll(root) - Destructs and frees all nodes of the tree with
+//                       the given root. The tree must not hold any
+//                       nodes of this allocator afterwards.
+//  * adopt(other)     - Allows this allocator to destroy nodes created by
+//                       other. Needed to move nodes between trees, e.g.
+//                       by join() or merge(). Both allocators stay usable.
+//  * emptyCopy()      - Returns a new allocator without any nodes, but
+//                       configured like this one. Used to copy trees.
+//
+// Policies are not copyable but have to be movable without throwing. The
+// moved from allocator holds no nodes and stays usable.
+
+namespace base {
+// Calls destroy(node) for every node of the subtree below root. Works
+// without recursion and without extra memory, so even degenerated trees of
+// any height cannot overflow the stack: left children are rotated up until
+// the current node has none, then the node is destroyed and the walk goes
+// on with its right child. Child links are overwritten along the way.
+template <class NodeT, class Destroy>
+void destroySubtree(NodeT* root, Destroy destroy) {
+    NodeT* node = root;
+    while (node != nullptr) {
+        NodeT* left = node->getLeftChild();
+        if (left != nullptr) {
+            node->setLeftChild(left->getRightChild());
+            left->setRightChild(node);
+            node = left;
+        } else {
+            NodeT* right = node->getRightChild();
+            destroy(node);
+            node = right;
+        }
+    }
+}
+
+// Default policy. Every node lives in its own heap allocation.
+template <class NodeT>
+class HeapNodeAllocator {
+   public:
+    HeapNodeAllocator() = default;
+    HeapNodeAllocator(const HeapNodeAllocator&) = delete;
+    HeapNodeAllocator& operator=(const HeapNodeAllocator&) = delete;
+    HeapNodeAllocator(HeapNodeAllocator&&) noexcept = default;
+    HeapNodeAllocator& operator=(HeapNodeAllocator&&) noexcept = default;
+
+    template <class... Args>
+    NodeT* create(Args&&... args) {
+        return new NodeT(std::forward<Args>(args)...);
+    }
+
+    void destroy(NodeT* node) { delete node; }
+
+    void destroyAll(NodeT* root) {
+        destroySubtree(root, [](NodeT* node) { delete node; });
+    }
+
+    // All nodes come from the same heap, nothing to do
+    void adopt(HeapNodeAllocator&) {}
+
+    HeapNodeAllocator emptyCopy() const { return HeapNodeAllocator(); }
+};
+
+// Background thread destroying detached subtrees, see
+// BackgroundNodeAllocator. Subtrees are destroyed in the order they were
+// posted. The destructor destroys all subtrees still queued.
+class NodeReclaimer : public NONCOPYANDMOVEABLE {
+   public:
+    NodeReclaimer() : _thread(1) {}
+
+    // Queues destruction of the subtree below root, destroy is called for
+    // every node on the background thread
+    template <class NodeT, class Destroy>
+    void post(NodeT* root, Destroy destroy) {
+        if (root == nullptr) return;
+        _thread.submit([root, destroy]() { destroySubtree(root, destroy); });
+    }
+
+    // Blocks until all subtrees posted so far are destroyed
+    void drain() { _thread.submit([]() {}).wait(); }
+
+    // Reclaimer shared by all allocators that were not given their own
+    static NodeReclaimer& global() {
+        static NodeReclaimer reclaimer;
+        return reclaimer;
+    }
+
+   private:
+    ThreadPool _thread;
+};
+
+// Heap allocation like HeapNodeAllocator, but destroyAll() only hands the
+// detached root over to a NodeReclaimer and returns in O(1). clear() and the
+// destructor of a tree with millions of nodes therefore do not stall the
+// calling thread. The payloads are destroyed on the reclaimer thread, so
+// their destructors must not rely on running on the thread owning the tree.
+// Single nodes removed by erase() are still freed right away.
+template <class NodeT>
+class BackgroundNodeAllocator {
+   public:
+    // The global reclaimer is created here at the latest, so it is destroyed
+    // only after every tree using it, even trees with static storage duration
+    BackgroundNodeAllocator() : _reclaimer(&NodeReclaimer::global()) {}
+    BackgroundNodeAllocator(const BackgroundNodeAllocator&) = delete;
+    BackgroundNodeAllocator& operator=(const BackgroundNodeAllocator&) = delete;
+    BackgroundNodeAllocator(BackgroundNodeAllocator&&) noexcept = default;
+    BackgroundNodeAllocator& operator=(BackgroundNodeAllocator&&) noexcept = default;
+
+    template <class... Args>
+    NodeT* create(Args&&... args) {
+        return new NodeT(std::forward<Args>(args)...);
+    }
+
+    void destroy(NodeT* node) { delete node; }
+
+    void destroyAll(NodeT* root) {
+        _reclaimer->post(root, [](NodeT* node) { delete node; });
+    }
+
+    // All nodes come from the same heap, nothing to do
+    void adopt(BackgroundNodeAllocator&) {}
+
+    // The copy posts to the same reclaimer
+    BackgroundNodeAllocator emptyCopy() const {
+        BackgroundNodeAllocator copy;
+        copy._reclaimer = _reclaimer;
+        return copy;
+    }
+
+    // Uses reclaimer instead of the global one for all following
+    // destroyAll() calls. reclaimer has to outlive the allocator.
+    void setReclaimer(NodeReclaimer& reclaimer) { _reclaimer = &reclaimer; }
+
+    NodeReclaimer& getReclaimer() const { return *_reclaimer; }
+
+   private:
+    NodeReclaimer* _reclaimer;
+};
+
+// Carves nodes out of large slabs of memory. Nodes freed by destroy()
+// are kept in a free list and reused by the next create(). destroyAll()
+// hands back all slabs at once and does not need to visit a single node
+// if the node type is trivially destructible.
+//
+// Slabs start small and double in size with every new slab until
+// maxNodesPerSlab is reached, so small trees do not waste memory.
+//
+// adopt() combines the slabs of two allocators into one pool that both of
+// them use afterwards. As long as a pool is shared, destroyAll() has to
+// destroy the nodes one by one, as the other allocators may still hold
+// nodes in the same slabs.
+template <class NodeT>
+class SlabNodeAllocator {
+   public:
+    static constexpr std::size_t DEFAULT_MAX_NODES_PER_SLAB = 4096;
+
+    explicit SlabNodeAllocator(std::size_t maxNodesPerSlab = DEFAULT_MAX_NODES_PER_SLAB)
+        : _pool(std::make_shared<Pool>(maxNodesPerSlab)), _maxNodesPerSlab(maxNodesPerSlab) {}
+
+    SlabNodeAllocator(const SlabNodeAllocator&) = delete;
+    SlabNodeAllocator& operator=(const SlabNodeAllocator&) = delete;
+
+    // Only the pool handle moves, the nodes stay where they are. The moved
+    // from allocator gets a new empty pool once it is used again.
+    SlabNodeAllocator(SlabNodeAllocator&& other) noexcept
+        : _pool(std::move(other._pool)), _maxNodesPerSlab(other._maxNodesPerSlab) {}
+
+    SlabNodeAllocator& operator=(SlabNodeAllocator&& other) noexcept {
+        _pool = std::move(other._pool);
+        _maxNodesPerSlab = other._maxNodesPerSlab;
+        return *this;
+    }
+
+    template <class... Args>
+    NodeT* create(Args&&... args) {
+        Pool& pool = getPool();
+        Slot* slot = nullptr;
+        if (pool.freeList != nullptr) {
+            slot = pool.freeList;
+            pool.freeList = slot->next;
+        } else {
+            if (pool.next == pool.end) pool.addSlab();
+            slot = pool.next++;
+        }
+
+        try {
+            return new (slot->storage) NodeT(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.release(slot);
+            throw;
+        }
+    }
+
+    void destroy(NodeT* node) {
+        node->~NodeT();
+        getPool().release(reinterpret_cast<Slot*>(node));
+    }
+
+    void destroyAll(NodeT* root) {
+        // Moved from and not used since, so there is nothing to free
+        if (!_pool) return;
+        Pool& pool = getPool();
+        if (_pool.use_count() > 1) {
+            destroySubtree(root, [this](NodeT* node) { destroy(node); });
+            return;
+        }
+
+        if constexpr (!std::is_trivially_destructible_v<NodeT>) {
+            destroySubtree(root, [](NodeT* node) { node->~NodeT(); });
+        }
+        pool.slabs.clear();
+        pool.freeList = nullptr;
+        pool.next = nullptr;
+        pool.end = nullptr;
+    }
+
+    void adopt(SlabNodeAllocator& other) {
+        Pool& pool = getPool();
+        Pool& otherPool = other.getPool();
+        if (&pool == &otherPool) return;
+
+        pool.absorb(otherPool);
+        otherPool.forward = _pool;
+        other._pool = _pool;
+    }
+
+    // The copy gets its own pool with the same slab size limit
+    SlabNodeAllocator emptyCopy() const { return SlabNodeAllocator(maxNodesPerSlab()); }
+
+    // Number of slabs currently held by the allocator
+    std::size_t slabCount() const {
+        const Pool* pool = findPool();
+        return (pool != nullptr) ? pool->slabs.size() : 0;
+    }
+
+    std::size_t maxNodesPerSlab() const {
+        const Pool* pool = findPool();
+        return (pool != nullptr) ? pool->maxNodesPerSlab : std::max(_maxNodesPerSlab, MIN_NODES_PER_SLAB);
+    }
+
+   private:
+    static constexpr std::size_t MIN_NODES_PER_SLAB = 32;
+
+    union Slot {
+        Slot* next;
+        alignas(NodeT) unsigned char storage[sizeof(NodeT)];
+    };
+
+    struct Pool {
+        explicit Pool(std::size_t maxNodes)
+            : slabs(), freeList(nullptr), next(nullptr), end(nullptr), maxNodesPerSlab(maxNodes), forward() {
+            if (maxNodesPerSlab < MIN_NODES_PER_SLAB) maxNodesPerSlab = MIN_NODES_PER_SLAB;
+        }
+
+        void addSlab() {
+            std::size_t nodes = MIN_NODES_PER_SLAB;
+            if (!slabs.empty()) nodes = std::min(slabs.back().second * 2, maxNodesPerSlab);
+
+            slabs.emplace_back(std::make_unique<Slot[]>(nodes), nodes);
+            next = slabs.back().first.get();
+            end = next + nodes;
+        }
+
+        void release(Slot* slot) {
+            slot->next = freeList;
+            freeList = slot;
+        }
+
+        // Takes over all slabs of other. The unused rest of the current slab
+        // of other is put on the free list.
+        void absorb(Pool& other) {
+            for (; other.next != other.end; ++other.next) release(other.next);
+            while (other.freeList != nullptr) {
+                Slot* slot = other.freeList;
+                other.freeList = slot->next;
+                release(slot);
+            }
+            for (auto& slab : other.slabs) slabs.push_back(std::move(slab));
+            other.slabs.clear();
+            other.next = nullptr;
+            other.end = nullptr;
+        }
+
+        std::vector<std::pair<std::unique_ptr<Slot[]>, std::size_t>> slabs;
+        Slot* freeList;
+        Slot* next;
+        Slot* end;
+        std::size_t maxNodesPerSlab;
+        // Set once the slabs were handed over to another pool
+        std::shared_ptr<Pool> forward;
+    };
+
+    // Follows the pools that were absorbed by adopt() calls of other
+    // allocators sharing this pool and remembers the last one. Creates the
+    // pool of a moved from allocator.
+    Pool& getPool() {
+        if (!_pool) _pool = std::make_shared<Pool>(_maxNodesPerSlab);
+        while (_pool->forward) _pool = _pool->forward;
+        return *_pool;
+    }
+
+    // Like getPool() but without changing the allocator, so concurrent
+    // const calls are safe. Returns nullptr for a moved from allocator.
+    const Pool* findPool() const {
+        const Pool* pool = _pool.get();
+        while (pool != nullptr && pool->forward) pool = pool->forward.get();
+        return pool;
+    }
+
+    std::shared_ptr<Pool> _pool;
+    std::size_t _maxNodesPerSlab;
+};
+}  // namespace base
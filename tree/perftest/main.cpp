@@ -22,29 +22,533 @@
  * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
  * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <base/oshelper.h>
+#include <tree/btree.h>
+#include <tree/compacttree.h>
+#include <tree/concurrenttree.h>
+#include <tree/frozentree.h>
+#include <tree/persistenttree.h>
 #include <tree/tree.h>
+#include <tree/treeimage.h>
+#include <tree/treemap.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <random>
 #include <set>
+#include <string>
+#include <thread>
 #include <vector>
 
+namespace {
+typedef base::Tree<int> HeapTree;
+typedef base::Tree<int, std::less<>, base::SlabNodeAllocator> SlabTree;
+
+template <class Func>
+long long measureMs(Func func) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    func();
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+template <class Func>
+long long measureUs(Func func) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    func();
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+void printResult(const std::string& name, long long ms) {
+    std::cout << name << ms << " ms" << std::endl;
+}
+
+// Sums up all elements so that the compiler cannot drop the iteration
+template <class Container>
+long long iterateAll(const Container& container) {
+    long long sum = 0;
+    for (auto it = container.begin(); it != container.end(); ++it) sum += *it;
+    return sum;
+}
+
+// Strings longer than the small string buffer, so every copy of a payload
+// allocates. Shows the cost of copying payloads on insert, find and iterate.
+void runStringBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    const std::size_t NUM_OF_STRINGS = 1000000;
+    std::vector<std::string> strings;
+    for (std::size_t i = 0; i < NUM_OF_STRINGS && i < randomVector.size(); ++i) {
+        strings.push_back("a_long_common_prefix_for_all_keys_" + std::to_string(randomVector[i]));
+    }
+    std::multiset<std::string> stlTree;
+    base::Tree<std::string> heapTree;
+    base::Tree<std::string, std::less<>, base::SlabNodeAllocator> slabTree;
+
+    std::cout << "Start filling " << strings.size() << " strings into STL multiset and trees..." << std::endl;
+
+    long long stlInsert = measureMs([&]() {
+        for (auto it = strings.begin(); it != strings.end(); ++it) stlTree.insert(*it);
+    });
+    long long heapInsert = measureMs([&]() {
+        for (auto it = strings.begin(); it != strings.end(); ++it) heapTree.insert(*it);
+    });
+    long long slabInsert = measureMs([&]() {
+        for (auto it = strings.begin(); it != strings.end(); ++it) slabTree.insert(*it);
+    });
+
+    printResult("STL Multiset Time      : ", stlInsert);
+    printResult("AE Tree (heap) Time    : ", heapInsert);
+    printResult("AE Tree (slab) Time    : ", slabInsert);
+
+    std::cout << "Start finding and iterating strings..." << std::endl;
+
+    long long stlFind = measureMs([&]() {
+        for (auto it = strings.begin(); it != strings.end(); ++it) checksum += (stlTree.find(*it) != stlTree.end());
+        for (auto it = stlTree.begin(); it != stlTree.end(); ++it) checksum += it->size();
+    });
+    long long heapFind = measureMs([&]() {
+        for (auto it = strings.begin(); it != strings.end(); ++it) checksum += heapTree.contains(*it);
+        for (auto it = heapTree.begin(); it != heapTree.end(); ++it) checksum += it->size();
+    });
+    long long slabFind = measureMs([&]() {
+        for (auto it = strings.begin(); it != strings.end(); ++it) checksum += slabTree.contains(*it);
+        for (auto it = slabTree.begin(); it != slabTree.end(); ++it) checksum += it->size();
+    });
+
+    printResult("STL Multiset Time      : ", stlFind);
+    printResult("AE Tree (heap) Time    : ", heapFind);
+    printResult("AE Tree (slab) Time    : ", slabFind);
+}
+
+// Percentiles by walking from begin() compared to select() of a tree with
+// subtree sizes
+void runPercentileBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    const std::size_t NUM_OF_QUERIES = 9;
+    std::multiset<int> stlTree(randomVector.begin(), randomVector.end());
+    base::OrderStatisticTree<int> osTree(randomVector.begin(), randomVector.end());
+
+    std::cout << "Start querying " << NUM_OF_QUERIES << " percentiles of " << randomVector.size() << " integers..."
+              << std::endl;
+
+    long long stlQuery = measureUs([&]() {
+        for (std::size_t q = 1; q <= NUM_OF_QUERIES; ++q) {
+            checksum += *std::next(stlTree.begin(), stlTree.size() * q / (NUM_OF_QUERIES + 1));
+        }
+    });
+    long long osQuery = measureUs([&]() {
+        for (std::size_t q = 1; q <= NUM_OF_QUERIES; ++q) {
+            checksum += *osTree.select(osTree.size() * q / (NUM_OF_QUERIES + 1));
+        }
+    });
+
+    std::cout << "STL Multiset Time      : " << stlQuery << " us" << std::endl;
+    std::cout << "AE OrderStatisticTree  : " << osQuery << " us" << std::endl;
+}
+
+// Merging a smaller tree into a large one by re-inserting every item
+// compared to the join based merge()
+void runMergeBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    const std::size_t NUM_OF_MERGED = randomVector.size() / 10;
+    std::vector<int> large(randomVector.begin() + NUM_OF_MERGED, randomVector.end());
+    std::sort(large.begin(), large.end());
+    std::vector<int> small(randomVector.begin(), randomVector.begin() + NUM_OF_MERGED);
+    std::sort(small.begin(), small.end());
+
+    HeapTree insertTree(large.begin(), large.end());
+    HeapTree insertSource(small.begin(), small.end());
+    HeapTree mergeTree(large.begin(), large.end());
+    HeapTree mergeSource(small.begin(), small.end());
+
+    std::cout << "Start merging " << small.size() << " into " << large.size() << " integers..." << std::endl;
+
+    long long insertMerge = measureMs([&]() {
+        for (auto it = insertSource.begin(); it != insertSource.end(); ++it) insertTree.insert(*it);
+        insertSource.clear();
+    });
+    long long joinMerge = measureMs([&]() { mergeTree.merge(mergeSource); });
+    checksum += insertTree.size() + mergeTree.size();
+
+    printResult("AE Tree insert() Time  : ", insertMerge);
+    printResult("AE Tree merge() Time   : ", joinMerge);
+}
+
+// Bulk insert of a batch as large as the tree and subtracting it again with
+// pools of different sizes. The calling thread helps while waiting, so a
+// pool for n threads gets n - 1 workers.
+void runParallelBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    std::default_random_engine randEngine(42);
+    std::uniform_int_distribution<int> randDist(-1000000, 1000000);
+    std::vector<int> batch;
+    for (std::size_t i = 0; i < randomVector.size(); ++i) batch.push_back(randDist(randEngine));
+    std::vector<int> sortedBase(randomVector);
+    std::sort(sortedBase.begin(), sortedBase.end());
+    HeapTree batchTree(batch.begin(), batch.end());
+
+    std::cout << "Start bulk inserting " << batch.size() << " into " << sortedBase.size() << " integers..."
+              << std::endl;
+
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u}) {
+        base::ThreadPool pool(threads - 1);
+        HeapTree tree(sortedBase.begin(), sortedBase.end());
+
+        long long insertTime = measureMs([&]() { tree.insert(batch.begin(), batch.end(), pool); });
+        long long subtractTime = measureMs([&]() { tree.subtract(batchTree, pool); });
+        checksum += tree.size();
+
+        std::cout << "Threads: " << threads << std::endl;
+        printResult("AE Tree insert() Time  : ", insertTime);
+        printResult("AE Tree subtract() Time: ", subtractTime);
+    }
+}
+
+// Runs read(reader, readers) on each of the reader threads while the calling
+// thread runs write()
+template <class ReadFunc, class WriteFunc>
+void runReadersAndWriter(unsigned readers, ReadFunc read, WriteFunc write) {
+    std::vector<std::thread> threads;
+    for (unsigned reader = 0; reader < readers; ++reader) {
+        threads.emplace_back([&read, reader, readers]() { read(reader, readers); });
+    }
+    write();
+    for (auto& thread : threads) thread.join();
+}
+
+// Lookups spread over several reader threads while one writer inserts, in
+// a ConcurrentTree and in a Tree behind a mutex
+void runConcurrentReadBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    const std::size_t NUM_OF_ITEMS = randomVector.size() / 10;
+    const unsigned NUM_OF_LOOKUPS = 2000000;
+    const int NUM_OF_WRITES = 1000;
+    std::vector<int> items(randomVector.begin(), randomVector.begin() + NUM_OF_ITEMS);
+    base::ConcurrentTree<int> concurrentTree;
+    concurrentTree.insert(items.begin(), items.end());
+    HeapTree lockedTree(items.begin(), items.end());
+    std::mutex lockedTreeMutex;
+    std::atomic<long long> found(0);
+
+    std::cout << "Start looking up " << NUM_OF_LOOKUPS << " integers in " << NUM_OF_ITEMS
+              << " integers with several readers and one writer..." << std::endl;
+
+    for (unsigned readers : {1u, 2u, 4u, 8u}) {
+        long long concurrentTime = measureMs([&]() {
+            runReadersAndWriter(
+                readers,
+                [&](unsigned reader, unsigned step) {
+                    long long sum = 0;
+                    for (unsigned i = reader; i < NUM_OF_LOOKUPS; i += step) {
+                        sum += concurrentTree.contains(items[i % NUM_OF_ITEMS]);
+                    }
+                    found += sum;
+                },
+                [&]() {
+                    for (int i = 0; i < NUM_OF_WRITES; ++i) concurrentTree.insert(i);
+                });
+        });
+        long long lockedTime = measureMs([&]() {
+            runReadersAndWriter(
+                readers,
+                [&](unsigned reader, unsigned step) {
+                    long long sum = 0;
+                    for (unsigned i = reader; i < NUM_OF_LOOKUPS; i += step) {
+                        std::lock_guard<std::mutex> lock(lockedTreeMutex);
+                        sum += lockedTree.contains(items[i % NUM_OF_ITEMS]);
+                    }
+                    found += sum;
+                },
+                [&]() {
+                    for (int i = 0; i < NUM_OF_WRITES; ++i) {
+                        std::lock_guard<std::mutex> lock(lockedTreeMutex);
+                        lockedTree.insert(i);
+                    }
+                });
+        });
+
+        std::cout << "Readers: " << readers << std::endl;
+        printResult("AE ConcurrentTree Time : ", concurrentTime);
+        printResult("AE Tree with mutex Time: ", lockedTime);
+    }
+    checksum += found;
+}
+
+// Keeping a consistent version for a long running reader: copying a
+// multiset compared to a PersistentTree snapshot, and the cost of writing
+// while a snapshot shares the nodes
+void runSnapshotBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    const std::size_t NUM_OF_ITEMS = randomVector.size() / 10;
+    const std::size_t NUM_OF_WRITES = NUM_OF_ITEMS / 10;
+    std::multiset<int> stlTree(randomVector.begin(), randomVector.begin() + NUM_OF_ITEMS);
+    base::PersistentTree<int> persistentTree;
+    for (std::size_t i = 0; i < NUM_OF_ITEMS; ++i) persistentTree.insert(randomVector[i]);
+
+    std::cout << "Start taking a snapshot of " << NUM_OF_ITEMS << " integers..." << std::endl;
+
+    std::multiset<int> stlCopy;
+    base::PersistentTree<int> snapshot;
+    long long stlSnapshot = measureUs([&]() { stlCopy = stlTree; });
+    long long persistentSnapshot = measureUs([&]() { snapshot = persistentTree.snapshot(); });
+    std::cout << "STL Multiset copy Time : " << stlSnapshot << " us" << std::endl;
+    std::cout << "AE PersistentTree Time : " << persistentSnapshot << " us" << std::endl;
+
+    std::cout << "Start inserting " << NUM_OF_WRITES << " integers with and without snapshot..." << std::endl;
+
+    long long sharedInsert = measureMs([&]() {
+        for (std::size_t i = 0; i < NUM_OF_WRITES; ++i) persistentTree.insert(randomVector[NUM_OF_ITEMS + i]);
+    });
+    checksum += iterateAll(snapshot) + static_cast<long long>(stlCopy.size());
+    snapshot.clear();
+    long long exclusiveInsert = measureMs([&]() {
+        for (std::size_t i = 0; i < NUM_OF_WRITES; ++i) persistentTree.insert(randomVector[NUM_OF_ITEMS + i]);
+    });
+    checksum += persistentTree.size();
+
+    printResult("Shared with snapshot   : ", sharedInsert);
+    printResult("Not shared             : ", exclusiveInsert);
+}
+
+void runThreadedBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    const std::size_t NUM_OF_ITEMS = randomVector.size() / 10;
+    HeapTree heapTree;
+    base::ThreadedTree<int> threadedTree;
+
+    std::cout << "Start inserting " << NUM_OF_ITEMS << " integers into plain and threaded tree..." << std::endl;
+    long long heapInsert = measureMs([&]() {
+        for (std::size_t i = 0; i < NUM_OF_ITEMS; ++i) heapTree.insert(randomVector[i]);
+    });
+    long long threadedInsert = measureMs([&]() {
+        for (std::size_t i = 0; i < NUM_OF_ITEMS; ++i) threadedTree.insert(randomVector[i]);
+    });
+    printResult("AE Tree Time           : ", heapInsert);
+    printResult("AE ThreadedTree Time   : ", threadedInsert);
+
+    std::cout << "Start iterating over all integers..." << std::endl;
+    long long heapIterate = measureMs([&]() { checksum += iterateAll(heapTree); });
+    long long threadedIterate = measureMs([&]() { checksum += iterateAll(threadedTree); });
+    printResult("AE Tree Time           : ", heapIterate);
+    printResult("AE ThreadedTree Time   : ", threadedIterate);
+}
+
+// Saves a filled tree to a file and gets it back by loading and by mapping
+void runImageBenchmark(const HeapTree& tree, long long& checksum) {
+    std::filesystem::path dir = base::createTempDir("aelib_tree_perftest");
+    std::filesystem::path file = dir / "tree.img";
+
+    std::cout << "Start saving and loading " << tree.size() << " integers..." << std::endl;
+    long long save = measureMs([&]() {
+        std::ofstream out(file, std::ios::binary);
+        tree.save(out);
+    });
+    HeapTree loaded;
+    long long load = measureMs([&]() {
+        std::ifstream in(file, std::ios::binary);
+        loaded.load(in);
+    });
+    long long mapAndFind = measureMs([&]() {
+        base::TreeImage<int> image(file);
+        for (int i = -499999; i < 500000; ++i) checksum += image.contains(i);
+    });
+    checksum += static_cast<long long>(loaded.size());
+    std::filesystem::remove_all(dir);
+
+    printResult("AE Tree save() Time    : ", save);
+    printResult("AE Tree load() Time    : ", load);
+    printResult("Map image + 1M finds   : ", mapAndFind);
+}
+
+// Shows what inserts and lookups cost inside the tree and the overhead of
+// counting it
+void runStatisticsBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    const std::size_t NUM_OF_ITEMS = randomVector.size() / 10;
+    HeapTree heapTree;
+    base::InstrumentedTree<int> instrumentedTree;
+
+    std::cout << "Start inserting and finding " << NUM_OF_ITEMS << " integers with statistics..." << std::endl;
+    long long heapTime = measureMs([&]() {
+        for (std::size_t i = 0; i < NUM_OF_ITEMS; ++i) heapTree.insert(randomVector[i]);
+        for (int i = -499999; i < 500000; ++i) checksum += heapTree.contains(i);
+    });
+    long long instrumentedTime = measureMs([&]() {
+        for (std::size_t i = 0; i < NUM_OF_ITEMS; ++i) instrumentedTree.insert(randomVector[i]);
+        for (int i = -499999; i < 500000; ++i) checksum += instrumentedTree.contains(i);
+    });
+
+    printResult("AE Tree Time           : ", heapTime);
+    printResult("AE InstrumentedTree    : ", instrumentedTime);
+    std::cout << instrumentedTree.getStatistics();
+}
+
+// Inserts, finds and erases values with one balancing policy. A second,
+// instrumented run counts the rotations and rebalance steps, the timed run
+// is not slowed down by the counters.
+template <class Balance>
+void runBalancePolicy(const std::string& name, const std::vector<int>& values, long long& checksum) {
+    typedef base::TreeOptions<base::NoFeatures, Balance> Options;
+    typedef base::TreeOptions<base::Statistics, Balance> InstrumentedOptions;
+    base::Tree<int, std::less<>, base::HeapNodeAllocator, Options> tree;
+    base::Tree<int, std::less<>, base::HeapNodeAllocator, InstrumentedOptions> instrumentedTree;
+
+    long long insertTime = measureMs([&]() {
+        for (int value : values) tree.insert(value);
+    });
+    uint32_t height = tree.getHeight();
+    long long findTime = measureMs([&]() {
+        for (int value : values) checksum += tree.contains(value);
+    });
+    long long eraseTime = measureMs([&]() {
+        for (int value : values) tree.erase(tree.find(value));
+    });
+    for (int value : values) instrumentedTree.insert(value);
+    uint64_t insertRotations = instrumentedTree.getStatistics().rotations;
+    instrumentedTree.resetStatistics();
+    for (int value : values) instrumentedTree.erase(instrumentedTree.find(value));
+    uint64_t eraseRotations = instrumentedTree.getStatistics().rotations;
+    uint64_t eraseSteps = instrumentedTree.getStatistics().rebalanceSteps;
+
+    std::cout << name << "insert " << insertTime << " ms, find " << findTime << " ms, erase " << eraseTime
+              << " ms, height " << height << ", rotations " << insertRotations << " / " << eraseRotations
+              << ", erase rebalance steps " << eraseSteps << std::endl;
+}
+
+// Erase heavy mix: erases a random half of the items and inserts them again,
+// several rounds in a row. Only the erases are counted, including the most
+// rotations a single erase needed, which WavlBalance bounds by two.
+template <class Balance>
+void runEraseHeavyPolicy(const std::string& name, const std::vector<int>& values, long long& checksum) {
+    typedef base::TreeOptions<base::Statistics, Balance> InstrumentedOptions;
+    typedef base::Tree<int, std::less<>, base::HeapNodeAllocator, InstrumentedOptions> InstrumentedTree;
+    const int NUM_OF_ROUNDS = 4;
+    InstrumentedTree tree;
+    for (int value : values) tree.insert(value);
+    std::vector<int> items(values);
+    std::default_random_engine randEngine;
+
+    uint64_t erases = 0;
+    uint64_t rotations = 0;
+    uint64_t steps = 0;
+    uint64_t maxRotations = 0;
+    for (int round = 0; round < NUM_OF_ROUNDS; ++round) {
+        std::shuffle(items.begin(), items.end(), randEngine);
+        auto half = items.begin() + static_cast<std::ptrdiff_t>(items.size() / 2);
+        tree.resetStatistics();
+        for (auto it = items.begin(); it != half; ++it) {
+            uint64_t before = tree.getStatistics().rotations;
+            tree.erase(tree.find(*it));
+            maxRotations = std::max(maxRotations, tree.getStatistics().rotations - before);
+        }
+        erases += tree.getStatistics().erases;
+        rotations += tree.getStatistics().rotations;
+        steps += tree.getStatistics().rebalanceSteps;
+        for (auto it = items.begin(); it != half; ++it) tree.insert(*it);
+    }
+    checksum += static_cast<long long>(tree.size());
+
+    std::cout << name << erases << " erases, rotations per erase " << static_cast<double>(rotations) / erases
+              << ", at most " << maxRotations << " in one erase, rebalance steps per erase "
+              << static_cast<double>(steps) / erases << ", height " << tree.getHeight() << std::endl;
+}
+
+// Shows the trade-off between tree height and rebalancing work
+void runBalanceBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    std::vector<int> values(randomVector.begin(), randomVector.begin() + randomVector.size() / 10);
+
+    std::cout << "Start inserting, finding and erasing " << values.size()
+              << " integers with different balancing policies..." << std::endl;
+    runBalancePolicy<base::AvlBalance>("AE Tree (AVL)          : ", values, checksum);
+    runBalancePolicy<base::HeightBalance<2>>("AE RelaxedTree         : ", values, checksum);
+    runBalancePolicy<base::HeightBalance<3>>("AE Tree (imbalance 3)  : ", values, checksum);
+    runBalancePolicy<base::WavlBalance>("AE WavlTree            : ", values, checksum);
+
+    std::cout << "Start erasing and inserting again random halves of " << values.size()
+              << " integers with different balancing policies..." << std::endl;
+    runEraseHeavyPolicy<base::AvlBalance>("AE Tree (AVL)          : ", values, checksum);
+    runEraseHeavyPolicy<base::HeightBalance<2>>("AE RelaxedTree         : ", values, checksum);
+    runEraseHeavyPolicy<base::WavlBalance>("AE WavlTree            : ", values, checksum);
+}
+
+// Counts the occurrences of keys, every count is updated in place
+void runTreeMapBenchmark(const std::vector<int>& randomVector, long long& checksum) {
+    const std::size_t NUM_OF_ITEMS = randomVector.size() / 10;
+    std::map<int, long long> stlMap;
+    base::TreeMap<int, long long> treeMap;
+
+    std::cout << "Start counting " << NUM_OF_ITEMS << " keys in maps..." << std::endl;
+    long long stlCount = measureMs([&]() {
+        for (std::size_t i = 0; i < NUM_OF_ITEMS; ++i) ++stlMap[randomVector[i] % 100000];
+    });
+    long long treeMapCount = measureMs([&]() {
+        for (std::size_t i = 0; i < NUM_OF_ITEMS; ++i) ++treeMap[randomVector[i] % 100000];
+    });
+    checksum += static_cast<long long>(stlMap.size() + treeMap.size());
+
+    printResult("STL Map Time           : ", stlCount);
+    printResult("AE TreeMap Time        : ", treeMapCount);
+}
+
+// Inserts one input pattern into an STL multiset with hint, into a Tree
+// without hint and into a Tree with hint. The hint is begin() for reversed
+// input and end() otherwise. Slab trees keep the allocation cost out of it.
+void runHintedInsertPattern(const std::string& name, const std::vector<int>& values, bool reversed,
+                            long long& checksum) {
+    std::cout << "Start inserting " << values.size() << " " << name << " integers..." << std::endl;
+
+    std::multiset<int> stlTree;
+    SlabTree plainTree;
+    SlabTree hintedTree;
+    long long stlInsert = measureMs([&]() {
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            stlTree.insert(reversed ? stlTree.begin() : stlTree.end(), *it);
+        }
+    });
+    long long plainInsert = measureMs([&]() {
+        for (auto it = values.begin(); it != values.end(); ++it) plainTree.insert(*it);
+    });
+    long long hintedInsert = measureMs([&]() {
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            hintedTree.insert(reversed ? hintedTree.begin() : hintedTree.end(), *it);
+        }
+    });
+    checksum += static_cast<long long>(stlTree.size() + plainTree.size() + hintedTree.size());
+
+    printResult("STL Multiset with hint : ", stlInsert);
+    printResult("AE Tree without hint   : ", plainInsert);
+    printResult("AE Tree with hint      : ", hintedInsert);
+}
+
+void runHintedInsertBenchmark(std::size_t numOfItems, long long& checksum) {
+    std::vector<int> values;
+    for (std::size_t i = 0; i < numOfItems; ++i) values.push_back(static_cast<int>(i));
+    runHintedInsertPattern("sorted", values, false, checksum);
+
+    std::vector<int> reversed(values.rbegin(), values.rend());
+    runHintedInsertPattern("reverse sorted", reversed, true, checksum);
+
+    // Every 100th item arrives up to 50 positions too early
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<std::size_t> distance(1, 50);
+    for (std::size_t i = 100; i < values.size(); i += 100) std::swap(values[i], values[i - distance(randEngine)]);
+    runHintedInsertPattern("nearly sorted", values, false, checksum);
+}
+}  // namespace
+
 int main(int argc, char** argv) {
     (void)argc;
     (void)argv;
     const int NUM_OF_NODES = 10000000;
-    std::chrono::high_resolution_clock::time_point stlStart;
-    std::chrono::high_resolution_clock::time_point stlEnd;
-    std::chrono::high_resolution_clock::time_point myStart;
-    std::chrono::high_resolution_clock::time_point myEnd;
     std::vector<int> randomVector;
     std::default_random_engine randEngine;
     std::uniform_int_distribution<int> randDist(-1000000, 1000000);
     std::multiset<int> stlTree;
-    base::Tree<int> myTree;
-    std::multiset<int>::iterator stlIt;
-    base::Tree<int>::iterator myIt;
+    HeapTree heapTree;
+    SlabTree slabTree;
+    base::CompactTree<int> compactTree;
+    base::BTree<int> bTree;
+    long long checksum = 0;
 
     // std::ofstream file("test.dot");
 
@@ -56,43 +560,118 @@ int main(int argc, char** argv) {
         randomVector.push_back(randDist(randEngine));
     }
 
-    std::cout << "Start filling random numbers into STL multiset..." << std::endl;
+    std::cout << "Start filling random numbers into STL multiset and all trees..." << std::endl;
 
-    stlStart = std::chrono::high_resolution_clock::now();
-    for (auto it = randomVector.begin(); it != randomVector.end(); ++it) stlTree.insert(*it);
-    stlEnd = std::chrono::high_resolution_clock::now();
+    long long stlInsert = measureMs([&]() {
+        for (auto it = randomVector.begin(); it != randomVector.end(); ++it) stlTree.insert(*it);
+    });
+    long long heapInsert = measureMs([&]() {
+        for (auto it = randomVector.begin(); it != randomVector.end(); ++it) heapTree.insert(*it);
+    });
+    long long slabInsert = measureMs([&]() {
+        for (auto it = randomVector.begin(); it != randomVector.end(); ++it) slabTree.insert(*it);
+    });
+    long long compactInsert = measureMs([&]() {
+        for (auto it = randomVector.begin(); it != randomVector.end(); ++it) compactTree.insert(*it);
+    });
+    long long bTreeInsert = measureMs([&]() {
+        for (auto it = randomVector.begin(); it != randomVector.end(); ++it) bTree.insert(*it);
+    });
 
-    std::cout << "Start filling random numbers into my tree..." << std::endl;
+    // slabTree.streamStructureToDotFormat(file, "", ++(slabTree.begin()));
 
-    myStart = std::chrono::high_resolution_clock::now();
-    for (auto it = randomVector.begin(); it != randomVector.end(); ++it) myTree.insert(*it);
-    myEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "Finished inserting " << NUM_OF_NODES << " integers!" << std::endl;
+    printResult("STL Multiset Time      : ", stlInsert);
+    printResult("AE Tree (heap) Time    : ", heapInsert);
+    printResult("AE Tree (slab) Time    : ", slabInsert);
+    printResult("AE CompactTree Time    : ", compactInsert);
+    printResult("AE BTree Time          : ", bTreeInsert);
 
-    // myTree.streamStructureToDotFormat(file, "", ++(myTree.begin()));
+    std::cout << "Start finding integers..." << std::endl;
 
-    std::cout << "Finished inserting " << NUM_OF_NODES << " integers!" << std::endl;
-    std::cout << "STL Multiset Time : "
-              << std::chrono::duration_cast<std::chrono::milliseconds>(stlEnd - stlStart).count() << " ms" << std::endl;
-    std::cout << "AE Tree Time      : "
-              << std::chrono::duration_cast<std::chrono::milliseconds>(myEnd - myStart).count() << " ms" << std::endl;
+    long long stlFind = measureMs([&]() {
+        for (int i = -499999; i < 500000; ++i) checksum += (stlTree.find(i) != stlTree.end());
+    });
+    long long heapFind = measureMs([&]() {
+        for (int i = -499999; i < 500000; ++i) checksum += (heapTree.find(i) != heapTree.end());
+    });
+    long long slabFind = measureMs([&]() {
+        for (int i = -499999; i < 500000; ++i) checksum += (slabTree.find(i) != slabTree.end());
+    });
+    long long compactFind = measureMs([&]() {
+        for (int i = -499999; i < 500000; ++i) checksum += (compactTree.find(i) != compactTree.end());
+    });
+    long long bTreeFind = measureMs([&]() {
+        for (int i = -499999; i < 500000; ++i) checksum += (bTree.find(i) != bTree.end());
+    });
+    std::vector<int> findKeys;
+    for (int i = -499999; i < 500000; ++i) findKeys.push_back(i);
+    std::vector<HeapTree::iterator> batchResults(findKeys.size());
+    long long heapBatchFind = measureMs([&]() {
+        heapTree.find_batch(findKeys.begin(), findKeys.end(), batchResults.begin());
+        for (auto it = batchResults.begin(); it != batchResults.end(); ++it) checksum += (*it != heapTree.end());
+    });
+    base::FrozenTree<int> frozenTree;
+    long long freezeTime = measureMs([&]() { frozenTree = heapTree.freeze(); });
+    long long frozenFind = measureMs([&]() {
+        for (int i = -499999; i < 500000; ++i) checksum += (frozenTree.find(i) != frozenTree.end());
+    });
+
+    std::cout << "Finished searching a million times in " << NUM_OF_NODES << " integers!" << std::endl;
+    printResult("STL Multiset Time      : ", stlFind);
+    printResult("AE Tree (heap) Time    : ", heapFind);
+    printResult("AE Tree (slab) Time    : ", slabFind);
+    printResult("AE CompactTree Time    : ", compactFind);
+    printResult("AE Tree (heap) batched : ", heapBatchFind);
+    printResult("AE BTree Time          : ", bTreeFind);
+    printResult("AE FrozenTree Time     : ", frozenFind);
+    printResult("AE Tree freeze() Time  : ", freezeTime);
 
-    std::cout << "Start finding integers in STL multiset..." << std::endl;
+    std::cout << "Start iterating over all integers..." << std::endl;
 
-    stlStart = std::chrono::high_resolution_clock::now();
-    for (int i = -499999; i < 500000; ++i) stlIt = stlTree.find(i);
-    stlEnd = std::chrono::high_resolution_clock::now();
+    long long stlIterate = measureMs([&]() { checksum += iterateAll(stlTree); });
+    long long heapIterate = measureMs([&]() { checksum += iterateAll(heapTree); });
+    long long slabIterate = measureMs([&]() { checksum += iterateAll(slabTree); });
+    long long compactIterate = measureMs([&]() { checksum += iterateAll(compactTree); });
+    long long bTreeIterate = measureMs([&]() { checksum += iterateAll(bTree); });
 
-    std::cout << "Start finding integers in my tree..." << std::endl;
+    std::cout << "Finished iterating over " << NUM_OF_NODES << " integers!" << std::endl;
+    printResult("STL Multiset Time      : ", stlIterate);
+    printResult("AE Tree (heap) Time    : ", heapIterate);
+    printResult("AE Tree (slab) Time    : ", slabIterate);
+    printResult("AE CompactTree Time    : ", compactIterate);
+    printResult("AE BTree Time          : ", bTreeIterate);
 
-    myStart = std::chrono::high_resolution_clock::now();
-    for (int i = -499999; i < 500000; ++i) myIt = myTree.find(i);
-    myEnd = std::chrono::high_resolution_clock::now();
+    runImageBenchmark(heapTree, checksum);
 
-    std::cout << "Finished searching a million times in " << NUM_OF_NODES << " integers!" << std::endl;
-    std::cout << "STL Multiset Time : "
-              << std::chrono::duration_cast<std::chrono::milliseconds>(stlEnd - stlStart).count() << " ms" << std::endl;
-    std::cout << "AE Tree Time      : "
-              << std::chrono::duration_cast<std::chrono::milliseconds>(myEnd - myStart).count() << " ms" << std::endl;
+    std::cout << "Start clearing all containers..." << std::endl;
+
+    long long stlClear = measureMs([&]() { stlTree.clear(); });
+    long long heapClear = measureMs([&]() { heapTree.clear(); });
+    long long slabClear = measureMs([&]() { slabTree.clear(); });
+    long long compactClear = measureMs([&]() { compactTree.clear(); });
+    long long bTreeClear = measureMs([&]() { bTree.clear(); });
+
+    std::cout << "Finished clearing " << NUM_OF_NODES << " integers!" << std::endl;
+    printResult("STL Multiset Time      : ", stlClear);
+    printResult("AE Tree (heap) Time    : ", heapClear);
+    printResult("AE Tree (slab) Time    : ", slabClear);
+    printResult("AE CompactTree Time    : ", compactClear);
+    printResult("AE BTree Time          : ", bTreeClear);
+
+    runStringBenchmark(randomVector, checksum);
+    runPercentileBenchmark(randomVector, checksum);
+    runMergeBenchmark(randomVector, checksum);
+    runParallelBenchmark(randomVector, checksum);
+    runConcurrentReadBenchmark(randomVector, checksum);
+    runSnapshotBenchmark(randomVector, checksum);
+    runHintedInsertBenchmark(randomVector.size() / 10, checksum);
+    runThreadedBenchmark(randomVector, checksum);
+    runTreeMapBenchmark(randomVector, checksum);
+    runStatisticsBenchmark(randomVector, checksum);
+    runBalanceBenchmark(randomVector, checksum);
+
+    std::cout << "(Checksum: " << checksum << ")" << std::endl;
 
     return 0;
 }
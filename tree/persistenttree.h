@@ -0,0 +1,397 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace base {
+template <class T>
+class PersistentNode {
+   public:
+    template <class... Args>
+    explicit PersistentNode(Args&&... args)
+        : _refs(1), _height(1), _left(nullptr), _right(nullptr), _payload(std::forward<Args>(args)...) {}
+
+    const T& getPayload() const { return _payload; }
+    const PersistentNode* getLeftChild() const { return _left; }
+    const PersistentNode* getRightChild() const { return _right; }
+    uint32_t getHeight() const { return _height; }
+
+   private:
+    template <class, class>
+    friend class PersistentTree;
+
+    std::atomic<uint32_t> _refs;
+    uint32_t _height;
+    PersistentNode* _left;
+    PersistentNode* _right;
+    T _payload;
+};
+
+// Forward iterator keeping the path from the root as a stack, as the
+// nodes of a PersistentTree have no parent pointers
+template <class T>
+class PersistentIterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    PersistentIterator() : _path() {}
+
+    const T& operator*() const {
+        if (_path.empty()) throw std::out_of_range("Iterator reached end of container, no dereferencing possible");
+        return _path.back()->getPayload();
+    }
+
+    const T* operator->() const { return &operator*(); }
+
+    bool operator==(const PersistentIterator& other) const {
+        if (_path.empty() || other._path.empty()) return _path.empty() == other._path.empty();
+        return _path.back() == other._path.back();
+    }
+
+    bool operator!=(const PersistentIterator& other) const { return !operator==(other); }
+
+    PersistentIterator& operator++() {
+        if (_path.empty()) return *this;
+        const PersistentNode<T>* current = _path.back();
+        _path.pop_back();
+        pushLeftPath(current->getRightChild());
+        return *this;
+    }
+
+    PersistentIterator operator++(int) {
+        PersistentIterator copy(*this);
+        operator++();
+        return copy;
+    }
+
+   private:
+    template <class, class>
+    friend class PersistentTree;
+
+    // Pushes node and all its left descendants, the last one is the smallest
+    void pushLeftPath(const PersistentNode<T>* node) {
+        while (node != nullptr) {
+            _path.push_back(node);
+            node = node->getLeftChild();
+        }
+    }
+
+    // Ancestors whose left subtree contains the current node, and the
+    // current node itself on top
+    std::vector<const PersistentNode<T>*> _path;
+};
+
+/**
+ * @brief      AVL tree whose versions share their unchanged nodes
+ *
+ * snapshot() returns a copy of the tree in O(1). insert() and erase() copy
+ * the nodes on the path to the change instead of modifying nodes that are
+ * used by another version (path copying), so a snapshot never changes and
+ * both versions together only need O(log n) additional nodes per change.
+ * Nodes used by a single version are modified in place.
+ *
+ * Nodes have atomic reference counts, so versions sharing nodes can be used
+ * and destroyed in different threads, e.g. iterating a snapshot while the
+ * tree is written. A single version must not be read and written at the
+ * same time. Iterators are invalidated by any change of the version they
+ * come from, iterate a snapshot to keep them valid.
+ */
+template <class T, class Compare = std::less<>>
+class PersistentTree {
+   public:
+    typedef PersistentNode<T> node_type;
+    typedef PersistentIterator<T> iterator;
+    typedef Compare compare_type;
+
+    PersistentTree() : _root(nullptr), _comp(), _size(0) {}
+    explicit PersistentTree(Compare compare) : _root(nullptr), _comp(std::move(compare)), _size(0) {}
+
+    PersistentTree(const PersistentTree& other) : _root(acquire(other._root)), _comp(other._comp), _size(other._size) {}
+
+    PersistentTree(PersistentTree&& other) noexcept
+        : _root(other._root), _comp(std::move(other._comp)), _size(other._size) {
+        other._root = nullptr;
+        other._size = 0;
+    }
+
+    PersistentTree& operator=(PersistentTree other) noexcept {
+        std::swap(_root, other._root);
+        std::swap(_comp, other._comp);
+        std::swap(_size, other._size);
+        return *this;
+    }
+
+    ~PersistentTree() { release(_root); }
+
+    // Copy of the current version in O(1). Changes of the copy and of this
+    // tree do not affect each other.
+    PersistentTree snapshot() const { return *this; }
+
+    // Items comparing equal to existing ones are placed behind them
+    void insert(const T& item) { emplace(item); }
+
+    void insert(T&& item) { emplace(std::move(item)); }
+
+    template <class... Args>
+    void emplace(Args&&... args) {
+        node_type* leaf = new node_type(std::forward<Args>(args)...);
+        _root = insertNode(_root, leaf);
+        ++_size;
+    }
+
+    // Removes all items comparing equal to key and returns their number
+    template <class K>
+    std::size_t erase(const K& key) {
+        std::size_t erased = 0;
+        while (findNode(key) != nullptr) {
+            _root = eraseNode(_root, key);
+            ++erased;
+        }
+        _size -= erased;
+        return erased;
+    }
+
+    // Iterator to the first item comparing equal to key or end()
+    template <class K>
+    iterator find(const K& key) const {
+        iterator result;
+        const node_type* current = _root;
+        while (current != nullptr) {
+            if (_comp(current->getPayload(), key)) {
+                current = current->getRightChild();
+            } else {
+                result._path.push_back(current);
+                current = current->getLeftChild();
+            }
+        }
+        // The last node pushed is the first one not less than key, the ones
+        // below it are the ancestors still to be visited after it
+        if (result._path.empty() || _comp(key, result._path.back()->getPayload())) return end();
+        return result;
+    }
+
+    template <class K>
+    bool contains(const K& key) const {
+        return findNode(key) != nullptr;
+    }
+
+    iterator begin() const {
+        iterator result;
+        result.pushLeftPath(_root);
+        return result;
+    }
+
+    iterator end() const { return iterator(); }
+
+    std::size_t size() const { return _size; }
+
+    bool empty() const { return _root == nullptr; }
+
+    void clear() {
+        release(_root);
+        _root = nullptr;
+        _size = 0;
+    }
+
+    uint32_t getHeight() const { return height(_root); }
+
+#ifdef _AE_TREE_DEBUGMODE_
+    const node_type* getRootNode() const { return _root; }
+#endif
+
+   private:
+    static node_type* acquire(node_type* node) {
+        if (node != nullptr) node->_refs.fetch_add(1, std::memory_order_relaxed);
+        return node;
+    }
+
+    static void release(node_type* node) {
+        if (node != nullptr && node->_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            release(node->_left);
+            release(node->_right);
+            delete node;
+        }
+    }
+
+    // Takes over a reference to node and returns a node with the same
+    // content that is used by nobody else and therefore may be modified
+    static node_type* unshare(node_type* node) {
+        if (node->_refs.load(std::memory_order_acquire) == 1) return node;
+
+        node_type* copy = new node_type(node->_payload);
+        copy->_height = node->_height;
+        copy->_left = acquire(node->_left);
+        copy->_right = acquire(node->_right);
+        release(node);
+        return copy;
+    }
+
+    // Takes over a reference to node and hands out references to its
+    // children, which are moved out if nobody else uses node
+    static void detachChildren(node_type* node, node_type*& left, node_type*& right) {
+        if (node->_refs.load(std::memory_order_acquire) == 1) {
+            left = node->_left;
+            right = node->_right;
+            node->_left = nullptr;
+            node->_right = nullptr;
+        } else {
+            left = acquire(node->_left);
+            right = acquire(node->_right);
+        }
+        release(node);
+    }
+
+    static uint32_t height(const node_type* node) { return (node != nullptr) ? node->_height : 0; }
+
+    static int32_t balanceOf(const node_type* node) {
+        return static_cast<int32_t>(height(node->_left)) - static_cast<int32_t>(height(node->_right));
+    }
+
+    static void updateHeight(node_type* node) { node->_height = std::max(height(node->_left), height(node->_right)) + 1; }
+
+    // All node functions below take over the references to the nodes they
+    // get and return a reference to the resulting subtree
+    static node_type* rotateLeft(node_type* node) {
+        node = unshare(node);
+        node_type* right = unshare(node->_right);
+        node->_right = right->_left;
+        right->_left = node;
+        updateHeight(node);
+        updateHeight(right);
+        return right;
+    }
+
+    static node_type* rotateRight(node_type* node) {
+        node = unshare(node);
+        node_type* left = unshare(node->_left);
+        node->_left = left->_right;
+        left->_right = node;
+        updateHeight(node);
+        updateHeight(left);
+        return left;
+    }
+
+    // node must be unshared already, its children differ in height by at
+    // most two
+    static node_type* rebalance(node_type* node) {
+        updateHeight(node);
+        int32_t balance = balanceOf(node);
+        if (balance > 1) {
+            if (balanceOf(node->_left) < 0) node->_left = rotateLeft(node->_left);
+            return rotateRight(node);
+        }
+        if (balance < -1) {
+            if (balanceOf(node->_right) > 0) node->_right = rotateRight(node->_right);
+            return rotateLeft(node);
+        }
+        return node;
+    }
+
+    node_type* insertNode(node_type* node, node_type* leaf) {
+        if (node == nullptr) return leaf;
+
+        node = unshare(node);
+        if (_comp(leaf->_payload, node->_payload)) {
+            node->_left = insertNode(node->_left, leaf);
+        } else {
+            node->_right = insertNode(node->_right, leaf);
+        }
+        return rebalance(node);
+    }
+
+    // Removes the smallest node of the subtree and hands it out as min,
+    // unshared and without children
+    static node_type* extractMin(node_type* node, node_type*& min) {
+        if (node->_left == nullptr) {
+            min = unshare(node);
+            node_type* right = min->_right;
+            min->_right = nullptr;
+            return right;
+        }
+        node = unshare(node);
+        node->_left = extractMin(node->_left, min);
+        return rebalance(node);
+    }
+
+    // Precondition: the subtree contains an item comparing equal to key
+    template <class K>
+    node_type* eraseNode(node_type* node, const K& key) {
+        if (_comp(key, node->_payload)) {
+            node = unshare(node);
+            node->_left = eraseNode(node->_left, key);
+            return rebalance(node);
+        }
+        if (_comp(node->_payload, key)) {
+            node = unshare(node);
+            node->_right = eraseNode(node->_right, key);
+            return rebalance(node);
+        }
+
+        node_type* left = nullptr;
+        node_type* right = nullptr;
+        detachChildren(node, left, right);
+        if (left == nullptr) return right;
+        if (right == nullptr) return left;
+
+        // The smallest node of the right subtree takes the place of node
+        node_type* min = nullptr;
+        right = extractMin(right, min);
+        min->_left = left;
+        min->_right = right;
+        return rebalance(min);
+    }
+
+    template <class K>
+    const node_type* findNode(const K& key) const {
+        const node_type* current = _root;
+        while (current != nullptr) {
+            if (_comp(key, current->getPayload())) {
+                current = current->getLeftChild();
+            } else if (_comp(current->getPayload(), key)) {
+                current = current->getRightChild();
+            } else {
+                return current;
+            }
+        }
+        return nullptr;
+    }
+
+    node_type* _root;
+    Compare _comp;
+    std::size_t _size;
+};
+}  // namespace base
@@ -23,78 +23,194 @@
  * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #pragma once
+#include <base/helpers.h>
+#include <base/parallel_sort.h>
+#include <base/threadpool.h>
+
+#include <algorithm>
 #include <fstream>
 #include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "frozentree.h"
 #include "iterator.h"
 #include "node.h"
+#include "nodeallocator.h"
 #include "treehelper.h"
-
-// TODO: Maybe think about offering different
-//       sorting strategies:
-//       * Day�Stout�Warren_algorithm to balance a tree
-//         on demand
-//       * Existing AVL tree algorithms to keep tree
-//         balanced at all times!?
+#include "treeimageheader.h"
+#include "treeoptions.h"
+#include "treestatistics.h"
 
 namespace base {
-template <class T>
+// Compare is a function object type defining a strict weak ordering on T.
+// Using the type directly instead of a std::function allows the compiler to
+// inline every comparison. If Compare defines is_transparent, like the
+// default std::less<>, find() and contains() also accept any type that is
+// comparable to T, e.g. a std::string_view for a Tree<std::string>.
+// Options selects the node features and the balancing policy, see
+// TreeOptions.
+template <class T, class Compare = std::less<>, template <class> class Allocator = HeapNodeAllocator,
+          class Options = TreeOptions<>>
 class Tree {
    public:
-    typedef base::Iterator<T> iterator;
+    typedef base::Node<T, Options> node_type;
+    typedef base::Iterator<T, Options> iterator;
+    typedef Allocator<node_type> allocator_type;
+    typedef Compare compare_type;
 
     Tree()
         : _root(nullptr),
-          _comp(std::less<T>()),
+          _alloc(),
+          _comp(),
 #ifdef _AE_TREE_DEBUGMODE_
           _dbgcb(),
 #endif
-          _size(0) {
+          _size(0),
+          _stats() {
     }
-    Tree(std::function<bool(T, T)> compare)
+    explicit Tree(Compare compare)
         : _root(nullptr),
-          _comp(compare),
+          _alloc(),
+          _comp(std::move(compare)),
 #ifdef _AE_TREE_DEBUGMODE_
           _dbgcb(),
 #endif
-          _size(0) {
+          _size(0),
+          _stats() {
+    }
+
+    // Builds the tree out of the elements of [first, last), see assign()
+    template <class InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    Tree(InputIt first, InputIt last) : Tree() {
+        assign(first, last);
+    }
+    template <class InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    Tree(InputIt first, InputIt last, Compare compare) : Tree(std::move(compare)) {
+        assign(first, last);
+    }
+
+    // Copies the structure of other node by node in O(n) without a single
+    // comparison or rotation. The copy gets its own allocator configured like
+    // the one of other, the debug callback and the statistics are not copied.
+    Tree(const Tree& other) : Tree(other._comp, other._alloc.emptyCopy()) { copyFrom(other, nullptr); }
+
+    // Copies large trees in parallel, see assign(const Tree&, ThreadPool&)
+    Tree(const Tree& other, ThreadPool& pool) : Tree(other._comp, other._alloc.emptyCopy()) {
+        copyFrom(other, &pool);
+    }
+
+    // Keeps the allocator of this tree, like assign(const Tree&, ThreadPool&)
+    Tree& operator=(const Tree& other) {
+        copyFrom(other, nullptr);
+        return *this;
+    }
+
+    // Takes over the nodes and the allocator of other in O(1), other is left
+    // empty. Iterators into other stay valid and now refer to this tree.
+    Tree(Tree&& other) noexcept
+        : _root(std::exchange(other._root, nullptr)),
+          _alloc(std::move(other._alloc)),
+          _comp(std::move(other._comp)),
+#ifdef _AE_TREE_DEBUGMODE_
+          _dbgcb(std::move(other._dbgcb)),
+#endif
+          _size(std::exchange(other._size, 0)),
+          _stats(other._stats) {
+    }
+
+    Tree& operator=(Tree&& other) noexcept {
+        if (&other == this) return *this;
+
+        _alloc.destroyAll(_root);
+        _root = std::exchange(other._root, nullptr);
+        _alloc = std::move(other._alloc);
+        _comp = std::move(other._comp);
+#ifdef _AE_TREE_DEBUGMODE_
+        _dbgcb = std::move(other._dbgcb);
+#endif
+        _size = std::exchange(other._size, 0);
+        _stats = other._stats;
+        return *this;
     }
 
     virtual ~Tree() {
-        TreeHelper<T>::recursiveDestroyNode(_root);
+        _alloc.destroyAll(_root);
         _root = nullptr;
         _size = 0;
     }
 
 #ifdef _AE_TREE_DEBUGMODE_
-    void setDebugCallback(std::function<void(const Tree<T>&, std::string, iterator)> callback) { _dbgcb = callback; }
+    void setDebugCallback(std::function<void(const Tree&, std::string, iterator)> callback) { _dbgcb = callback; }
 #endif
 
     // Sorted insertion of an item into the tree respecting the comparison
-    // function.
-    // TODO: Optimize as described here:
-    //       http://www.geeksforgeeks.org/avl-tree-set-1-insertion/
-    void insert(T item) {
-        Node<T>* insertee = new Node<T>(nullptr, item);
+    // function. Items comparing equal to existing ones are placed behind them.
+    iterator insert(const T& item) { return emplace(item); }
 
-        if (_root == nullptr) {  // Tree is empty so insert new node as root
-            _root = insertee;
-        } else {
-            recursiveInsert(_root, insertee);
-#ifdef _AE_TREE_DEBUGMODE_
-            if (_dbgcb) _dbgcb(*this, "post_insert", iterator(insertee));
-#endif
-            // TODO: Embed balance into recursiveInsertion
-            balance(insertee->getParent());
+    iterator insert(T&& item) { return emplace(std::move(item)); }
+
+    // Like insert() but constructs the item in place from args, so it is
+    // never copied or moved
+    template <class... Args>
+    iterator emplace(Args&&... args) {
+        node_type* insertee = _alloc.create(nullptr, std::forward<Args>(args)...);
+        return insertNode(insertee, [&]() { attachLeaf(insertee, _root); });
+    }
+
+    // Constructs an item from args unless an item comparing equal to key
+    // exists already, with a single descent. The constructed item must
+    // compare equal to key. Returns the item comparing equal to key and
+    // whether it was inserted, see TreeMap.
+    template <class K, class... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        node_type* parent = nullptr;
+        bool isLeftChild = false;
+        for (node_type* current = _root; current != nullptr;) {
+            parent = current;
+            if (isLess(key, current->getPayload()) == true) {
+                isLeftChild = true;
+                current = current->getLeftChild();
+            } else if (isLess(current->getPayload(), key) == true) {
+                isLeftChild = false;
+                current = current->getRightChild();
+            } else {
+                return std::make_pair(iterator(current), false);
+            }
         }
-        ++_size;
-#ifdef _AE_TREE_DEBUGMODE_
-        if (_dbgcb) _dbgcb(*this, "post_insert_and_balance", end());
-#endif
+
+        node_type* insertee = _alloc.create(nullptr, std::forward<Args>(args)...);
+        iterator inserted = insertNode(insertee, [&]() {
+            insertee->setParent(parent);
+            if (isLeftChild) {
+                parent->setLeftChild(insertee);
+            } else {
+                parent->setRightChild(insertee);
+            }
+        });
+        return std::make_pair(inserted, true);
+    }
+
+    // Inserts item as close before hint as the order allows. If item belongs
+    // right before or behind hint this takes O(1) comparisons, e.g. for
+    // ascending input with end() or the previously inserted item as hint.
+    // Otherwise the search climbs from hint only as far as needed, which
+    // takes O(log d) comparisons for a distance of d items.
+    iterator insert(iterator hint, const T& item) { return emplace_hint(hint, item); }
+
+    iterator insert(iterator hint, T&& item) { return emplace_hint(hint, std::move(item)); }
+
+    template <class... Args>
+    iterator emplace_hint(iterator hint, Args&&... args) {
+        node_type* insertee = _alloc.create(nullptr, std::forward<Args>(args)...);
+        return insertNode(insertee, [&]() { attachLeafNear(insertee, hint._current); });
     }
 
 #ifdef _AE_TREE_DEBUGMODE_
-    Node<T>* getRootNode() { return _root; }
+    node_type* getRootNode() { return _root; }
 #endif
 
     // Precondtiion: extratext must be of format [a-zA-Z0-9_]+
@@ -105,7 +221,7 @@ class Tree {
         out << "}\n";
     }
 
-    void recursiveStreamStructureToDotFormat(Node<T>* current, std::ostream& out, iterator highlight) const {
+    void recursiveStreamStructureToDotFormat(node_type* current, std::ostream& out, iterator highlight) const {
         if (current == nullptr) {
             out << "\tempty [shape=\"rectangle\" label=\"NULL\"];\n";
             return;
@@ -133,15 +249,20 @@ class Tree {
         }
     }
 
-    void erase(iterator position) {
-        if (position == end()) return;
+    // Removes the item at position and returns an iterator to the item
+    // behind it. Nodes are only relinked, never payloads moved, so iterators
+    // to all other items stay valid. An item with two children is replaced by
+    // its in-order successor node, which is taken out of its own place first.
+    iterator erase(iterator position) {
+        if (position == end()) return end();
 
-        Node<T>* x = position._current;
-        Node<T>* par = x->getParent();
+        node_type* x = position._current;
+        node_type* par = x->getParent();
         uint8_t children = 0;
-        Node<T>* lc = x->getLeftChild();
-        Node<T>* rc = x->getRightChild();
-        Node<T>* child = nullptr;  // any child
+        node_type* lc = x->getLeftChild();
+        node_type* rc = x->getRightChild();
+        node_type* child = nullptr;  // any child
+        uint32_t parHeight = (par != nullptr) ? par->getHeight() : 0;
 
 #ifdef _AE_TREE_DEBUGMODE_
         if (_dbgcb) _dbgcb(*this, "pre_erase", position);
@@ -155,62 +276,291 @@ class Tree {
             child = rc;
         }
 
+        if constexpr (Options::statistics) ++_stats.erases;
         if (children == 0) {
+            ++position;
             if (_root == x) _root = nullptr;
+            unthreadNode(x);
             prepareForDelete(x, par, nullptr);
-            delete x;
+            _alloc.destroy(x);
 #ifdef _AE_TREE_DEBUGMODE_
             if (_dbgcb) _dbgcb(*this, "post_nochild_erase", iterator(par));
 #endif
-            balance(par);
+            rebalanceAfterErase(par, parHeight);
             --_size;
 #ifdef _AE_TREE_DEBUGMODE_
             if (_dbgcb) _dbgcb(*this, "post_nochild_erase_and_balance", iterator(par));
 #endif
         } else if (children == 1) {
+            ++position;
             if (_root == x) _root = child;
+            unthreadNode(x);
             prepareForDelete(x, par, child);
-            delete x;
+            _alloc.destroy(x);
 #ifdef _AE_TREE_DEBUGMODE_
             if (_dbgcb) _dbgcb(*this, "post_onechild_erase", iterator(par));
 #endif
-            balance(par);
+            rebalanceAfterErase(par, parHeight);
             --_size;
 #ifdef _AE_TREE_DEBUGMODE_
             if (_dbgcb) _dbgcb(*this, "post_onechild_erase_and_balance", iterator(par));
 #endif
         } else {
-            Node<T>* z = getLeftMostNode(rc);
+            node_type* z = getLeftMostNode(rc);
+            position = iterator(z);
 #ifdef _AE_TREE_DEBUGMODE_
             if (_dbgcb) _dbgcb(*this, "pre_twochild_erase_leftmostnode", iterator(z));
 #endif
-            x->swapPayload(z);
-            erase(iterator(z));
+            unthreadNode(x);
+            replaceBySuccessor(x, z);
+            _alloc.destroy(x);
+            --_size;
 #ifdef _AE_TREE_DEBUGMODE_
             if (_dbgcb) _dbgcb(*this, "post_twochild_erase", iterator(par));
 #endif
         }
+        return position;
     }
 
-    iterator find(const T& item) const { return recursiveFind(_root, item); }
+    // Removes all items comparing equal to item and returns their number
+    std::size_t erase(const T& item) { return eraseEqual(item); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    std::size_t erase(const K& key) {
+        return eraseEqual(key);
+    }
+
+    // Replaces the content of the tree by the elements of [first, last).
+    // Input that is already sorted by the comparison function is turned
+    // into a perfectly balanced tree in O(n) without any rotation. Other
+    // input is stable sorted first, using multiple threads for large ranges,
+    // so equal elements keep their order like with repeated insert().
+    template <class InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last) {
+        assignRange(first, last, nullptr);
+    }
+
+    // Replaces the content by a copy of other like operator=. The subtrees of
+    // large trees are copied in parallel on the threads of pool, every task
+    // creating its nodes with an allocator of its own that is adopted by
+    // this tree's allocator afterwards.
+    void assign(const Tree& other, ThreadPool& pool) { copyFrom(other, &pool); }
+
+    // Removes all items in [first, last) and returns last. The tree is split
+    // in front of first and last and the remaining parts are joined again,
+    // which takes O(log n + k) for k erased items. Like the single item
+    // erase, iterators to the remaining items stay valid.
+    iterator erase(iterator first, iterator last) {
+        if (first == last) return last;
+        if (first == begin() && last == end()) {
+            if constexpr (Options::statistics) _stats.erases += _size;
+            clear();
+            return end();
+        }
+
+        node_type* left = nullptr;
+        node_type* middle = nullptr;
+        node_type* right = nullptr;
+        splitBeforeNode(first._current, left, middle);
+        if (last != end()) splitBeforeNode(last._current, middle, right);
+        std::size_t erased = destroyNodes(middle);
+        threadBetween(left, right);
+        _root = joinSubtrees(left, right);
+        _size -= erased;
+        if constexpr (Options::statistics) _stats.erases += erased;
+        return last;
+    }
+
+    // Join based operations. They take the trees apart and put the pieces
+    // together again with a join of two subtrees and a node in between,
+    // which costs O(log n) at most.
+
+    // Moves all items not less than item into greater, which is cleared
+    // first. Takes O(log n) with TreeFeature::SubtreeSize, otherwise the k
+    // items moved are counted as well, which takes O(log n + k).
+    void split(const T& item, Tree& greater) {
+        if (&greater == this) throw std::invalid_argument("Tree::split needs a different tree to move items into");
+
+        greater.clear();
+        greater._alloc.adopt(_alloc);
+        node_type* left = nullptr;
+        node_type* right = nullptr;
+        splitNodes(_root, [&](const T& payload) { return isLess(payload, item); }, left, right);
+        threadBetween(left, nullptr);
+        threadBetween(nullptr, right);
+        std::size_t greaterSize = countNodes(right);
+        _root = left;
+        _size -= greaterSize;
+        greater._root = right;
+        greater._size = greaterSize;
+    }
+
+    // Appends all items of greater, which becomes empty. No item of greater
+    // may be less than an item of this tree. Takes O(log n).
+    void join(Tree& greater) {
+        if (&greater == this || greater._root == nullptr) return;
+        if (_root != nullptr &&
+            isLess(getLeftMostNode(greater._root)->getPayload(), getRightMostNode(_root)->getPayload()) == true) {
+            throw std::invalid_argument("Tree::join needs all items of greater to be behind the items of this tree");
+        }
+
+        _alloc.adopt(greater._alloc);
+        threadBetween(_root, greater._root);
+        _root = joinSubtrees(_root, greater._root);
+        _size += greater._size;
+        greater._root = nullptr;
+        greater._size = 0;
+    }
+
+    // Union: moves all items of other into this tree and leaves other empty.
+    // All items are kept, equal items of both trees end up next to each
+    // other in unspecified order. Takes O(m log(n / m + 1)) for m items in
+    // the smaller and n items in the larger tree.
+    void merge(Tree& other) { mergeWith(other, nullptr); }
+
+    // Intersection: keeps only the items comparing equal to an item of other
+    void intersect(const Tree& other) { filterBy(other, true, nullptr); }
+
+    // Difference: removes all items comparing equal to an item of other
+    void subtract(const Tree& other) { filterBy(other, false, nullptr); }
+
+    // Inserts all items of [first, last). They are sorted and built into a
+    // balanced tree first, which is then merged into this one. For large
+    // batches this is much faster than inserting item by item.
+    template <class InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void insert(InputIt first, InputIt last) {
+        Tree batch(_comp);
+        batch.assignRange(first, last, nullptr);
+        merge(batch);
+    }
+
+    // Parallel variants of the operations above. The recursion on independent
+    // subtrees is spread over the threads of pool, so the comparison function
+    // is called concurrently. Nodes are only destroyed by the calling thread,
+    // the allocator does not need to be thread safe.
+    void merge(Tree& other, ThreadPool& pool) { mergeWith(other, &pool); }
+
+    void intersect(const Tree& other, ThreadPool& pool) { filterBy(other, true, &pool); }
+
+    void subtract(const Tree& other, ThreadPool& pool) { filterBy(other, false, &pool); }
+
+    template <class InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void insert(InputIt first, InputIt last, ThreadPool& pool) {
+        Tree batch(_comp);
+        batch.assignRange(first, last, &pool);
+        merge(batch, pool);
+    }
+
+    iterator find(const T& item) const { return iterator(findNode(item)); }
+
+    // Heterogeneous lookup, only available for a transparent Compare
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator find(const K& key) const { return iterator(findNode(key)); }
+
+    // Like find() but searches from hint outwards, which takes O(log d)
+    // comparisons for an item d positions away from hint. end() as hint
+    // starts from the largest item.
+    iterator find(iterator hint, const T& item) const { return iterator(findNodeNear(hint._current, item)); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator find(iterator hint, const K& key) const {
+        return iterator(findNodeNear(hint._current, key));
+    }
 
     // Checks whether the provided item is contained inside the tree
-    bool contains(const T& item) const { return find(item) != end(); }
+    bool contains(const T& item) const { return findNode(item) != nullptr; }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    bool contains(const K& key) const { return findNode(key) != nullptr; }
+
+    // Returns an iterator to the first item not less than item or end()
+    iterator lower_bound(const T& item) const { return iterator(lowerBoundNode(item)); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator lower_bound(const K& key) const { return iterator(lowerBoundNode(key)); }
+
+    // Returns an iterator to the first item greater than item or end()
+    iterator upper_bound(const T& item) const { return iterator(upperBoundNode(item)); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator upper_bound(const K& key) const { return iterator(upperBoundNode(key)); }
+
+    // Returns the range of all items equal to item. Enumerating k duplicates
+    // takes O(log n + k).
+    std::pair<iterator, iterator> equal_range(const T& item) const {
+        return std::make_pair(lower_bound(item), upper_bound(item));
+    }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    std::pair<iterator, iterator> equal_range(const K& key) const {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    // Looks up all keys in [first, last) and writes one iterator per key to
+    // out, end() for missing keys, with the same results as find(). Groups of
+    // lookups descend in lockstep and prefetch their next nodes, so the cache
+    // misses of one group overlap instead of stalling one after another.
+    template <class ForwardIt, class OutputIt>
+    OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) const {
+        while (first != last) {
+            ForwardIt keys[BATCH_GROUP_SIZE];
+            node_type* current[BATCH_GROUP_SIZE];
+            bool found[BATCH_GROUP_SIZE];
+            std::size_t count = 0;
+            for (; count < BATCH_GROUP_SIZE && first != last; ++count, ++first) {
+                keys[count] = first;
+                current[count] = _root;
+                found[count] = false;
+            }
+
+            bool active = (_root != nullptr);
+            while (active) {
+                active = false;
+                for (std::size_t i = 0; i < count; ++i) {
+                    if (found[i] || current[i] == nullptr) continue;
+                    if (isLess(*keys[i], current[i]->getPayload()) == true) {
+                        current[i] = current[i]->getLeftChild();
+                    } else if (isLess(current[i]->getPayload(), *keys[i]) == true) {
+                        current[i] = current[i]->getRightChild();
+                    } else {
+                        found[i] = true;
+                        continue;
+                    }
+                    if (current[i] != nullptr) {
+                        prefetch(current[i]);
+                        active = true;
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i < count; ++i) *out++ = iterator(current[i]);
+        }
+        return out;
+    }
+
+    // Returns a lazy view on all items in the half open range [lo, hi),
+    // which can be used in range based for loops
+    IteratorRange<iterator> range(const T& lo, const T& hi) const { return makeRange(lo, hi); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    IteratorRange<iterator> range(const K& lo, const K& hi) const { return makeRange(lo, hi); }
 
     std::size_t size() const { return _size; }
 
-    bool empty() const { return size() == 0; }
+    bool empty() const { return _root == nullptr; }
 
     void clear() {
-        TreeHelper<T>::recursiveDestroyNode(_root);
+        _alloc.destroyAll(_root);
         _root = nullptr;
         _size = 0;
     }
 
-    iterator begin() const { return Iterator<T>(getLeftMostNode(_root)); }
+    iterator begin() const { return iterator(getLeftMostNode(_root)); }
 
-    iterator end() const { return Iterator<T>(nullptr); }
+    iterator end() const { return iterator(nullptr); }
 
+    // Height of the tree, for WavlBalance the rank of the root, which is an
+    // upper bound of the height
     uint32_t getHeight() const {
         if (_root != nullptr) {
             return _root->getHeight();
@@ -227,107 +577,1058 @@ class Tree {
         }
     }
 
+    const allocator_type& getAllocator() const { return _alloc; }
+
+    // For configuring the allocator, e.g. BackgroundNodeAllocator::setReclaimer()
+    allocator_type& getAllocator() { return _alloc; }
+
+    // Counters since construction or the last reset. Need
+    // TreeFeature::Statistics.
+    const TreeStatistics& getStatistics() const {
+        static_assert(Options::statistics, "getStatistics() needs TreeFeature::Statistics");
+        return _stats;
+    }
+
+    void resetStatistics() {
+        static_assert(Options::statistics, "resetStatistics() needs TreeFeature::Statistics");
+        _stats = TreeStatistics();
+    }
+
+    // Writes all items in order as binary image, which load() and TreeImage,
+    // see treeimage.h, read again. Needs a trivially copyable T, whose bytes are written.
+    void save(std::ostream& out) const {
+        static_assert(std::is_trivially_copyable_v<T>, "Tree::save(out) writes raw items, use save(out, writeItem)");
+        TreeImageHeader::forRawItems<T>(size()).write(out);
+        for (iterator it = begin(); it != end(); ++it) out.write(reinterpret_cast<const char*>(&*it), sizeof(T));
+        if (!out) throw std::runtime_error("Writing the tree image failed");
+    }
+
+    // For any T, writeItem(out, item) encodes a single item
+    template <class Writer>
+    void save(std::ostream& out, Writer writeItem) const {
+        TreeImageHeader::forEncodedItems(size()).write(out);
+        for (iterator it = begin(); it != end(); ++it) writeItem(out, *it);
+        if (!out) throw std::runtime_error("Writing the tree image failed");
+    }
+
+    // Replaces the content by the items of an image written by save(). They
+    // are in order already, so the tree is built perfectly balanced in O(n)
+    // without a single comparison or rotation. The image must have been
+    // written by a tree with the same order. Throws std::runtime_error for
+    // images that do not fit T or are truncated.
+    void load(std::istream& in) {
+        static_assert(std::is_trivially_copyable_v<T>, "Tree::load(in) reads raw items, use load(in, readItem)");
+        TreeImageHeader header = TreeImageHeader::read(in, sizeof(T));
+        // The count is not trusted before the items arrived, a broken image
+        // must not allocate memory for items it does not contain
+        std::vector<T> items;
+        for (uint64_t remaining = header.count; remaining > 0;) {
+            std::size_t chunk = static_cast<std::size_t>(std::min<uint64_t>(remaining, LOAD_CHUNK_ITEMS));
+            std::size_t offset = items.size();
+            items.resize(offset + chunk);
+            char* target = reinterpret_cast<char*>(items.data() + offset);
+            if (!in.read(target, static_cast<std::streamsize>(chunk * sizeof(T)))) {
+                throw std::runtime_error("Tree image is truncated, items incomplete");
+            }
+            remaining -= chunk;
+        }
+        assignSorted(items.begin(), items.size());
+    }
+
+    // For any T, readItem(in) decodes and returns a single item
+    template <class Reader>
+    void load(std::istream& in, Reader readItem) {
+        TreeImageHeader header = TreeImageHeader::read(in, 0);
+        std::vector<T> items;
+        items.reserve(static_cast<std::size_t>(std::min<uint64_t>(header.count, LOAD_CHUNK_ITEMS)));
+        for (uint64_t i = 0; i < header.count; ++i) {
+            items.push_back(readItem(in));
+            if (!in) throw std::runtime_error("Tree image is truncated, items incomplete");
+        }
+        assignSorted(std::make_move_iterator(items.begin()), items.size());
+    }
+
+    // Read only copy of all items in a cache friendlier layout for faster
+    // lookups, see FrozenTree. Later changes to this tree are not reflected.
+    FrozenTree<T, Compare> freeze() const { return FrozenTree<T, Compare>(begin(), end(), _comp); }
+
+    // Order statistics, all in O(log n). They need TreeFeature::SubtreeSize,
+    // see OrderStatisticTree.
+
+    // Returns an iterator to the k-th smallest item, counting from 0, or
+    // end() if k >= size()
+    iterator select(std::size_t k) const {
+        static_assert(Options::subtreeSize, "select() needs TreeFeature::SubtreeSize");
+        node_type* current = _root;
+        while (current != nullptr) {
+            std::size_t leftSize = node_type::getSubtreeSize(current->getLeftChild());
+            if (k < leftSize) {
+                current = current->getLeftChild();
+            } else if (k == leftSize) {
+                break;
+            } else {
+                k -= leftSize + 1;
+                current = current->getRightChild();
+            }
+        }
+        return iterator(current);
+    }
+
+    // Returns the number of items comparing less than item, which is the
+    // position of the first item equal to item if there is any
+    std::size_t rank(const T& item) const { return rankOf(item); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    std::size_t rank(const K& key) const { return rankOf(key); }
+
+    // Returns the number of items in the half open range [lo, hi)
+    std::size_t count_range(const T& lo, const T& hi) const { return countRange(lo, hi); }
+
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    std::size_t count_range(const K& lo, const K& hi) const { return countRange(lo, hi); }
+
    private:
-    Tree(const Tree&);
+    Tree(Compare compare, allocator_type&& alloc)
+        : _root(nullptr),
+          _alloc(std::move(alloc)),
+          _comp(std::move(compare)),
+#ifdef _AE_TREE_DEBUGMODE_
+          _dbgcb(),
+#endif
+          _size(0),
+          _stats() {
+    }
+
+    typedef typename Options::balance_policy Balance;
+    static constexpr int32_t MAX_IMBALANCE = Balance::maxImbalance;
+    // Parallel operations recurse on smaller subtrees on the calling thread
+    static constexpr uint32_t PARALLEL_MIN_HEIGHT = 12;
+    // Lookups interleaved by find_batch(), enough to cover the memory latency
+    static constexpr std::size_t BATCH_GROUP_SIZE = 16;
+    // Items load() allocates ahead of reading them
+    static constexpr std::size_t LOAD_CHUNK_ITEMS = std::max<std::size_t>(1, (std::size_t(1) << 16) / sizeof(T));
 
-    void prepareForDelete(Node<T>* toDelete, Node<T>* parent, Node<T>* newChild) {
+    // All comparisons go through here to be counted
+    template <class L, class R>
+    bool isLess(const L& lhs, const R& rhs) const {
+        if constexpr (Options::statistics) ++_stats.comparisons;
+        return _comp(lhs, rhs);
+    }
+
+    void prepareForDelete(node_type* toDelete, node_type* parent, node_type* newChild) {
         if (parent != nullptr) {
             if (parent->getLeftChild() == toDelete) parent->setLeftChild(newChild);
             if (parent->getRightChild() == toDelete) parent->setRightChild(newChild);
-            if (newChild != nullptr) newChild->setParent(parent);
         }
+        // Also needed without parent, a child replacing the root becomes root
+        if (newChild != nullptr) newChild->setParent(parent);
+        if (parent != nullptr) adjustSubtreeSizes(parent->getParent(), -1);
     }
 
-    iterator recursiveFind(Node<T>* current, const T& item) const {
-        if (current == nullptr) return end();
-        // Check if item to search is smaller than current node
-        // if it is take the left child node...
-        if (_comp(item, current->getPayload()) == true) {
-            return recursiveFind(current->getLeftChild(), item);
+    // Puts z, the leftmost node below the right child of x, into the place of
+    // x and rebalances. x is unlinked afterwards but not destroyed.
+    void replaceBySuccessor(node_type* x, node_type* z) {
+        node_type* par = x->getParent();
+        node_type* lc = x->getLeftChild();
+        node_type* rc = x->getRightChild();
+        uint32_t parHeight = (par != nullptr) ? par->getHeight() : 0;
+
+        if (z == rc) {
+            // z keeps its right subtree and only gains the left one of x
+            adjustSubtreeSizes(par, -1);
+            lc->setParent(z);
+            z->setLeftChild(lc);
+            replaceChild(par, x, z);
+            if (par == nullptr) _root = z;
+            if constexpr (Balance::rankBalanced) {
+                // z takes over the rank of x, its right subtree lost a rank
+                z->setHeight(x->getHeight());
+                if (par != nullptr) par->setHeight(parHeight);
+                demoteAfterErase(z);
+                return;
+            }
+            // The parent of z already sees its new height, so z is rebalanced
+            // on its own and the walk upwards starts at the parent
+            if (!isBalanced(z)) z = rotate(z);
+            if (par != nullptr) rebalanceAfterErase(par, parHeight);
+            return;
         }
-        // ... if it is bigger take the right child node...
-        else if (_comp(current->getPayload(), item) == true) {
-            return recursiveFind(current->getRightChild(), item);
+
+        node_type* zp = z->getParent();
+        node_type* zr = z->getRightChild();
+        uint32_t zpHeight = zp->getHeight();
+        // Linked in while still inside rc, z sees the old heights of lc and rc
+        // and gets the height of x, so the parent of x does not notice the swap
+        lc->setParent(z);
+        rc->setParent(z);
+        z->setChildren(lc, rc);
+        replaceChild(par, x, z);
+        if (par == nullptr) _root = z;
+        if constexpr (Balance::rankBalanced) {
+            z->setHeight(x->getHeight());
+            if (par != nullptr) par->setHeight(parHeight);
         }
-        return iterator(current);
+
+        if (zr != nullptr) zr->setParent(zp);
+        zp->setLeftChild(zr);
+        adjustSubtreeSizes(zp->getParent(), -1);
+        rebalanceAfterErase(zp, zpHeight);
     }
 
-    void recursiveInsert(Node<T>* current, Node<T>* insertee) {
-        if (_comp(insertee->getPayload(), current->getPayload()) == true) {
-            // Check if the left child node exists already
-            if (current->getLeftChild() == nullptr) {
-                // If it does not, add the new node exactly here
-                insertee->setParent(current);
-                current->setLeftChild(insertee);
+    // Links node instead of child below parent, or as root without parent
+    static void replaceChild(node_type* parent, node_type* child, node_type* node) {
+        node->setParent(parent);
+        if (parent == nullptr) return;
+        if (parent->getLeftChild() == child) {
+            parent->setLeftChild(node);
+        } else {
+            parent->setRightChild(node);
+        }
+    }
+
+    template <class K>
+    std::size_t eraseEqual(const K& key) {
+        node_type* first = lowerBoundNode(key);
+        node_type* last = upperBoundNode(key);
+        std::size_t erased = 0;
+        for (iterator it(first), end(last); it != end; ++it) ++erased;
+        erase(iterator(first), iterator(last));
+        return erased;
+    }
+
+    // Adds delta to the subtree size of node and all of its ancestors.
+    // Does nothing without TreeFeature::SubtreeSize.
+    void adjustSubtreeSizes(node_type* node, int32_t delta) {
+        if constexpr (Options::subtreeSize) {
+            for (; node != nullptr; node = node->getParent()) node->adjustSubtreeSize(delta);
+        } else {
+            (void)node;
+            (void)delta;
+        }
+    }
+
+    template <class K>
+    node_type* lowerBoundNode(const K& item) const {
+        node_type* bound = nullptr;
+        node_type* current = _root;
+        while (current != nullptr) {
+            if (isLess(current->getPayload(), item) == true) {
+                current = current->getRightChild();
             } else {
-                // If it does, follow this branch
-                recursiveInsert(current->getLeftChild(), insertee);
+                bound = current;
+                current = current->getLeftChild();
+            }
+        }
+        return bound;
+    }
+
+    template <class K>
+    node_type* upperBoundNode(const K& item) const {
+        node_type* bound = nullptr;
+        node_type* current = _root;
+        while (current != nullptr) {
+            if (isLess(item, current->getPayload()) == true) {
+                bound = current;
+                current = current->getLeftChild();
+            } else {
+                current = current->getRightChild();
+            }
+        }
+        return bound;
+    }
+
+    template <class K>
+    IteratorRange<iterator> makeRange(const K& lo, const K& hi) const {
+        node_type* first = lowerBoundNode(lo);
+        // The range is empty, or even inverted, if its first item is not below hi
+        if (first == nullptr || isLess(first->getPayload(), hi) == false) return IteratorRange<iterator>(end(), end());
+        return IteratorRange<iterator>(iterator(first), iterator(lowerBoundNode(hi)));
+    }
+
+    template <class K>
+    std::size_t countRange(const K& lo, const K& hi) const {
+        std::size_t loRank = rankOf(lo);
+        std::size_t hiRank = rankOf(hi);
+        return (hiRank > loRank) ? hiRank - loRank : 0;
+    }
+
+    template <class K>
+    std::size_t rankOf(const K& item) const {
+        static_assert(Options::subtreeSize, "rank() needs TreeFeature::SubtreeSize");
+        std::size_t rank = 0;
+        node_type* current = _root;
+        while (current != nullptr) {
+            if (isLess(current->getPayload(), item) == true) {
+                rank += node_type::getSubtreeSize(current->getLeftChild()) + 1;
+                current = current->getRightChild();
+            } else {
+                current = current->getLeftChild();
+            }
+        }
+        return rank;
+    }
+
+    // Sorts unsorted input with the threads of pool if given
+    template <class InputIt>
+    void assignRange(InputIt first, InputIt last, ThreadPool* pool) {
+        typedef typename std::iterator_traits<InputIt>::iterator_category category;
+
+        clear();
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            if (std::is_sorted(first, last, _comp)) {
+                assignSorted(first, static_cast<std::size_t>(std::distance(first, last)));
+                return;
+            }
+        }
+
+        std::vector<T> items(first, last);
+        if (pool != nullptr) {
+            base::parallel_stable_sort(items.begin(), items.end(), _comp, *pool);
+        } else {
+            base::parallel_stable_sort(items.begin(), items.end(), _comp);
+        }
+        assignSorted(std::make_move_iterator(items.begin()), items.size());
+    }
+
+    // Replaces the content by count items of sorted input
+    template <class ForwardIt>
+    void assignSorted(ForwardIt first, std::size_t count) {
+        clear();
+        _root = buildBalancedSubtree(first, count);
+        _size = count;
+    }
+
+    // Builds a perfectly balanced subtree out of the next count elements
+    // of the sorted input and returns its root. Left subtrees are built
+    // first, so a forward iterator is sufficient.
+    template <class ForwardIt>
+    node_type* buildBalancedSubtree(ForwardIt& it, std::size_t count) {
+        if (count == 0) return nullptr;
+
+        std::size_t leftCount = count / 2;
+        node_type* left = buildBalancedSubtree(it, leftCount);
+        node_type* node = nullptr;
+        node_type* right = nullptr;
+        try {
+            node = _alloc.create(nullptr, *it);
+            ++it;
+            right = buildBalancedSubtree(it, count - leftCount - 1);
+        } catch (...) {
+            destroyNodes(left);
+            if (node != nullptr) _alloc.destroy(node);
+            throw;
+        }
+
+        threadAround(left, node, right);
+        if (left != nullptr) left->setParent(node);
+        if (right != nullptr) right->setParent(node);
+        node->setLeftChild(left);
+        node->setRightChild(right);
+        return node;
+    }
+
+    // Replaces the content by a copy of other. The copy is created before
+    // the old content is destroyed, so on an exception nothing changes.
+    void copyFrom(const Tree& other, ThreadPool* pool) {
+        if (this == &other) return;
+
+        allocator_type alloc = _alloc.emptyCopy();
+        node_type* root = cloneNodes(other._root, alloc, pool);
+        clear();
+        _alloc.adopt(alloc);
+        _root = root;
+        _comp = other._comp;
+        _size = other._size;
+    }
+
+    // Returns a copy of the subtree below node, created by alloc. With a pool
+    // the left subtree is copied by another task using a separate allocator.
+    node_type* cloneNodes(node_type* node, allocator_type& alloc, ThreadPool* pool) const {
+        if (node == nullptr) return nullptr;
+
+        ThreadPool* subPool = poolFor(pool, node);
+        if (subPool == nullptr) return cloneNode(node, alloc, alloc, nullptr);
+
+        allocator_type leftAlloc = alloc.emptyCopy();
+        return cloneNode(node, alloc, leftAlloc, subPool);
+    }
+
+    node_type* cloneNode(node_type* node, allocator_type& alloc, allocator_type& leftAlloc, ThreadPool* pool) const {
+        node_type* left = nullptr;
+        node_type* right = nullptr;
+        node_type* copy = nullptr;
+        try {
+            invokeBoth(
+                pool, [&]() { left = cloneNodes(node->getLeftChild(), leftAlloc, pool); },
+                [&]() { right = cloneNodes(node->getRightChild(), alloc, pool); });
+            copy = alloc.create(nullptr, node->getPayload());
+        } catch (...) {
+            base::destroySubtree(left, [&](node_type* n) { leftAlloc.destroy(n); });
+            base::destroySubtree(right, [&](node_type* n) { alloc.destroy(n); });
+            throw;
+        }
+        alloc.adopt(leftAlloc);
+
+        threadAround(left, copy, right);
+        if (left != nullptr) left->setParent(copy);
+        if (right != nullptr) right->setParent(copy);
+        copy->setChildren(left, right);
+        // Ranks of WavlBalance may exceed the height, so they are copied too
+        copy->setHeight(node->getHeight());
+        return copy;
+    }
+
+    // Destroys all nodes below and including node and returns their number
+    std::size_t destroyNodes(node_type* node) {
+        std::size_t count = 0;
+        base::destroySubtree(node, [&](node_type* n) {
+            _alloc.destroy(n);
+            ++count;
+        });
+        return count;
+    }
+
+    // Stored subtree sizes make this O(1), otherwise all nodes are visited
+    static std::size_t countNodes(node_type* node) {
+        if constexpr (Options::subtreeSize) {
+            return node_type::getSubtreeSize(node);
+        } else {
+            if (node == nullptr) return 0;
+            return countNodes(node->getLeftChild()) + countNodes(node->getRightChild()) + 1;
+        }
+    }
+
+    // Thread links of TreeFeature::Threaded, all of them do nothing without.
+    // Splits keep the links inside each part intact, as every part is a run
+    // of neighbours. Parts that were not neighbours before get linked right
+    // before they are joined. The links leaving a part at its ends are only
+    // valid once the part is linked to its new neighbours or cut by passing
+    // nullptr.
+
+    // Links the last node below left to the first node below right
+    static void threadBetween(node_type* left, node_type* right) {
+        if constexpr (Options::threaded) {
+            node_type::linkThread(getRightMostNode(left), getLeftMostNode(right));
+        } else {
+            (void)left;
+            (void)right;
+        }
+    }
+
+    // Links node between the subtrees left and right
+    static void threadAround(node_type* left, node_type* node, node_type* right) {
+        if constexpr (Options::threaded) {
+            node_type::linkThread(getRightMostNode(left), node);
+            node_type::linkThread(node, getLeftMostNode(right));
+        } else {
+            (void)left;
+            (void)node;
+            (void)right;
+        }
+    }
+
+    // Links a freshly attached leaf between its parent and the neighbour of
+    // the parent on the other side
+    static void threadLeaf(node_type* leaf) {
+        if constexpr (Options::threaded) {
+            node_type* parent = leaf->getParent();
+            if (parent->getLeftChild() == leaf) {
+                node_type::linkThread(parent->getPrev(), leaf);
+                node_type::linkThread(leaf, parent);
+            } else {
+                node_type::linkThread(leaf, parent->getNext());
+                node_type::linkThread(parent, leaf);
             }
         } else {
-            // Check if the right child node exists already
-            if (current->getRightChild() == nullptr) {
-                // If it does not, add the new node exactly here
-                insertee->setParent(current);
-                current->setRightChild(insertee);
+            (void)leaf;
+        }
+    }
+
+    static void unthreadNode(node_type* node) {
+        if constexpr (Options::threaded) {
+            node_type::linkThread(node->getPrev(), node->getNext());
+        } else {
+            (void)node;
+        }
+    }
+
+    static uint32_t heightOf(node_type* node) { return (node != nullptr) ? node->getHeight() : 0; }
+
+    static bool isBalanced(node_type* node) { return Balance::isBalanced(node->getBalance()); }
+
+    // Detaches both children of node, which become roots of their own
+    static void exposeNode(node_type* node, node_type*& left, node_type*& right) {
+        left = node->getLeftChild();
+        right = node->getRightChild();
+        if (left != nullptr) left->makeRoot();
+        if (right != nullptr) right->makeRoot();
+    }
+
+    // Makes node the root of a subtree with the given children
+    static node_type* linkNodes(node_type* left, node_type* node, node_type* right) {
+        if (left != nullptr) left->setParent(node);
+        if (right != nullptr) right->setParent(node);
+        node->setChildren(left, right);
+        node->makeRoot();
+        return node;
+    }
+
+    // Joins the subtrees left and right and node in between them into one
+    // balanced subtree. No item of left may be greater and no item of right
+    // may be less than the item of node. Takes O(|h(left) - h(right)| + 1).
+    static node_type* joinNodes(node_type* left, node_type* node, node_type* right) {
+        if (heightOf(left) > heightOf(right) + MAX_IMBALANCE) return joinRight(left, node, right);
+        if (heightOf(right) > heightOf(left) + MAX_IMBALANCE) return joinLeft(left, node, right);
+        return linkNodes(left, node, right);
+    }
+
+    // left is higher than right. Descends the right spine of left until the
+    // subtree there is about as high as right, links it with node and right
+    // and rotates on the way back up where the balance is violated.
+    static node_type* joinRight(node_type* left, node_type* node, node_type* right) {
+        node_type* ll = nullptr;
+        node_type* lr = nullptr;
+        exposeNode(left, ll, lr);
+
+        node_type* joined = nullptr;
+        if (heightOf(lr) <= heightOf(right) + MAX_IMBALANCE) {
+            joined = linkNodes(lr, node, right);
+        } else {
+            joined = joinRight(lr, node, right);
+        }
+        return rebalanceRoot(linkNodes(ll, left, joined));
+    }
+
+    // Mirror of joinRight() for a right subtree higher than left
+    static node_type* joinLeft(node_type* left, node_type* node, node_type* right) {
+        node_type* rl = nullptr;
+        node_type* rr = nullptr;
+        exposeNode(right, rl, rr);
+
+        node_type* joined = nullptr;
+        if (heightOf(rl) <= heightOf(left) + MAX_IMBALANCE) {
+            joined = linkNodes(left, node, rl);
+        } else {
+            joined = joinLeft(left, node, rl);
+        }
+        return rebalanceRoot(linkNodes(joined, right, rr));
+    }
+
+    // Rotates a subtree root that is out of balance by one more than the
+    // policy allows, like rotate() but without parent. A joined subtree
+    // leaning towards the inside needs the double rotation.
+    static node_type* rebalanceRoot(node_type* node) {
+        int32_t balance = node->getBalance();
+        if (balance > MAX_IMBALANCE) {
+            if (node->getRightChild()->getBalance() < 0) {
+                node = TreeHelper<T, Options>::leftRightRotateSubtree(node);
             } else {
-                // If it does, follow this branch
-                recursiveInsert(current->getRightChild(), insertee);
+                node = TreeHelper<T, Options>::leftRotateSubtree(node);
+            }
+        } else if (balance < -MAX_IMBALANCE) {
+            if (node->getLeftChild()->getBalance() > 0) {
+                node = TreeHelper<T, Options>::rightLeftRotateSubtree(node);
+            } else {
+                node = TreeHelper<T, Options>::rightRotateSubtree(node);
             }
         }
-        current->updateHeight();
+        node->makeRoot();
+        return node;
     }
 
-    void balance(Node<T>* node) {
-        Node<T>* newRoot = nullptr;
-        Node<T>* parent = nullptr;
-        int32_t nodeBalance = 0;
+    // Removes the last node of the subtree below node and returns it. rest
+    // becomes the root of the remaining subtree.
+    static node_type* splitLastNode(node_type* node, node_type*& rest) {
+        node_type* left = nullptr;
+        node_type* right = nullptr;
+        exposeNode(node, left, right);
+        if (right == nullptr) {
+            rest = left;
+            return node;
+        }
+
+        node_type* restRight = nullptr;
+        node_type* last = splitLastNode(right, restRight);
+        rest = joinNodes(left, node, restRight);
+        return last;
+    }
 
-        while (node != nullptr) {
-            parent = node->getParent();
-            newRoot = nullptr;
-            nodeBalance = node->getBalance();
-            if (nodeBalance > 1) {
-                if (node->getRightChild()->getBalance() < 0) {
-                    newRoot = TreeHelper<T>::leftRightRotateSubtree(node);
-                    updateParent(parent, node, newRoot);
+    // Joins two subtrees without a node in between, no item of left may be
+    // greater than an item of right
+    static node_type* joinSubtrees(node_type* left, node_type* right) {
+        if (left == nullptr) return right;
+        if (right == nullptr) return left;
+
+        node_type* rest = nullptr;
+        node_type* last = splitLastNode(left, rest);
+        return joinNodes(rest, last, right);
+    }
+
+    // Splits the subtree below node into the items for which goesLeft is true
+    // and the others. goesLeft must hold for a prefix of the items only.
+    template <class Pred>
+    static void splitNodes(node_type* node, const Pred& goesLeft, node_type*& left, node_type*& right) {
+        if (node == nullptr) {
+            left = nullptr;
+            right = nullptr;
+            return;
+        }
+
+        node_type* nl = nullptr;
+        node_type* nr = nullptr;
+        exposeNode(node, nl, nr);
+        if (goesLeft(node->getPayload())) {
+            node_type* rightOfLeft = nullptr;
+            splitNodes(nr, goesLeft, rightOfLeft, right);
+            left = joinNodes(nl, node, rightOfLeft);
+        } else {
+            node_type* leftOfRight = nullptr;
+            splitNodes(nl, goesLeft, left, leftOfRight);
+            right = joinNodes(leftOfRight, node, nr);
+        }
+    }
+
+    // Splits the tree in front of node, which becomes the first node of right.
+    // Walks up from node and joins the subtrees hanging off the path to the
+    // root on either side. The heights of the joined subtrees grow along the
+    // path, so all joins together take O(log n).
+    static void splitBeforeNode(node_type* node, node_type*& left, node_type*& right) {
+        node_type* parent = node->getParent();
+        node_type* child = node;
+        node_type* nr = nullptr;
+        exposeNode(node, left, nr);
+        right = joinNodes(nullptr, node, nr);
+
+        while (parent != nullptr) {
+            node_type* grandParent = parent->getParent();
+            // child is part of left or right already, only detach the sibling
+            if (parent->getLeftChild() == child) {
+                node_type* sibling = parent->getRightChild();
+                if (sibling != nullptr) sibling->makeRoot();
+                right = joinNodes(right, parent, sibling);
+            } else {
+                node_type* sibling = parent->getLeftChild();
+                if (sibling != nullptr) sibling->makeRoot();
+                left = joinNodes(sibling, parent, left);
+            }
+            child = parent;
+            parent = grandParent;
+        }
+    }
+
+    void mergeWith(Tree& other, ThreadPool* pool) {
+        if (&other == this || other._root == nullptr) return;
+
+        _alloc.adopt(other._alloc);
+        std::size_t mergedSize = _size + other._size;
+        node_type* large = _root;
+        node_type* small = other._root;
+        if (heightOf(small) > heightOf(large)) std::swap(small, large);
+        _root = unionNodes(large, small, pool);
+        _size = mergedSize;
+        other._root = nullptr;
+        other._size = 0;
+    }
+
+    void filterBy(const Tree& other, bool keepEqual, ThreadPool* pool) {
+        if (&other == this) {
+            if (!keepEqual) clear();
+            return;
+        }
+
+        std::vector<node_type*> discarded;
+        _root = filterNodes(_root, other._root, keepEqual, discarded, pool);
+        // The first and last remaining items may have had discarded neighbours
+        threadBetween(nullptr, _root);
+        threadBetween(_root, nullptr);
+        std::size_t erased = 0;
+        for (node_type* subtree : discarded) erased += destroyNodes(subtree);
+        _size -= erased;
+        if constexpr (Options::statistics) _stats.erases += erased;
+    }
+
+    // Runs first as task of pool and second on the calling thread, or both
+    // on the calling thread without pool. Returns once both are done, even
+    // if one of them throws.
+    template <class First, class Second>
+    static void invokeBoth(ThreadPool* pool, First first, Second second) {
+        if (pool == nullptr) {
+            first();
+            second();
+            return;
+        }
+
+        auto task = pool->submit(first);
+        try {
+            second();
+        } catch (...) {
+            try {
+                pool->wait(task);
+            } catch (...) {
+            }
+            throw;
+        }
+        pool->wait(task);
+    }
+
+    static ThreadPool* poolFor(ThreadPool* pool, node_type* subtree) {
+        // The counters are not synchronized
+        if constexpr (Options::statistics) return nullptr;
+        return (heightOf(subtree) >= PARALLEL_MIN_HEIGHT) ? pool : nullptr;
+    }
+
+    // Union of two subtrees keeping all items. The nodes of small serve as
+    // split points for large and are linked into the result.
+    node_type* unionNodes(node_type* large, node_type* small, ThreadPool* pool) {
+        if (large == nullptr) return small;
+        if (small == nullptr) return large;
+
+        node_type* sl = nullptr;
+        node_type* sr = nullptr;
+        exposeNode(small, sl, sr);
+        const T& key = small->getPayload();
+        node_type* ll = nullptr;
+        node_type* lr = nullptr;
+        splitNodes(large, [&](const T& payload) { return isLess(payload, key); }, ll, lr);
+
+        node_type* left = nullptr;
+        node_type* right = nullptr;
+        ThreadPool* subPool = poolFor(pool, small);
+        invokeBoth(
+            subPool, [&]() { left = unionNodes(ll, sl, subPool); }, [&]() { right = unionNodes(lr, sr, subPool); });
+        threadAround(left, small, right);
+        return joinNodes(left, small, right);
+    }
+
+    // Keeps (keepEqual) or removes the items of the subtree below node that
+    // compare equal to an item below filter and returns the new subtree.
+    // The subtree below filter is only read. Removed subtrees are collected
+    // in discarded instead of being destroyed right away.
+    node_type* filterNodes(node_type* node, node_type* filter, bool keepEqual, std::vector<node_type*>& discarded,
+                           ThreadPool* pool) {
+        if (node == nullptr) return nullptr;
+        if (filter == nullptr) {
+            if (!keepEqual) return node;
+            discarded.push_back(node);
+            return nullptr;
+        }
+
+        const T& key = filter->getPayload();
+        node_type* less = nullptr;
+        node_type* notLess = nullptr;
+        node_type* equal = nullptr;
+        node_type* greater = nullptr;
+        splitNodes(node, [&](const T& payload) { return isLess(payload, key); }, less, notLess);
+        splitNodes(notLess, [&](const T& payload) { return !isLess(key, payload); }, equal, greater);
+
+        node_type* left = nullptr;
+        node_type* right = nullptr;
+        ThreadPool* subPool = poolFor(pool, filter);
+        // A task running in parallel needs a list of its own
+        std::vector<node_type*> leftDiscarded;
+        std::vector<node_type*>& leftTarget = (subPool != nullptr) ? leftDiscarded : discarded;
+        invokeBoth(
+            subPool, [&]() { left = filterNodes(less, filter->getLeftChild(), keepEqual, leftTarget, subPool); },
+            [&]() { right = filterNodes(greater, filter->getRightChild(), keepEqual, discarded, subPool); });
+        discarded.insert(discarded.end(), leftDiscarded.begin(), leftDiscarded.end());
+
+        if (!keepEqual && equal != nullptr) {
+            discarded.push_back(equal);
+            equal = nullptr;
+        }
+        threadBetween(left, equal);
+        node_type* joined = joinSubtrees(left, equal);
+        threadBetween(joined, right);
+        return joinSubtrees(joined, right);
+    }
+
+    template <class K>
+    node_type* findNode(const K& item) const {
+        return findNodeBelow(_root, item);
+    }
+
+    // Finger search, climbs from hint to the lowest subtree which can
+    // contain item and searches only there
+    template <class K>
+    node_type* findNodeNear(node_type* hint, const K& item) const {
+        if (_root == nullptr) return nullptr;
+        node_type* finger = (hint != nullptr) ? hint : getRightMostNode(_root);
+        if (isLess(item, finger->getPayload()) == false && isLess(finger->getPayload(), item) == false) return finger;
+        return findNodeBelow(climbFrom(finger, item), item);
+    }
+
+    template <class K>
+    node_type* findNodeBelow(node_type* current, const K& item) const {
+        uint32_t depth = 0;
+        while (current != nullptr) {
+            ++depth;
+            // Check if item to search is smaller than current node
+            // if it is take the left child node...
+            if (isLess(item, current->getPayload()) == true) {
+                current = current->getLeftChild();
+            }
+            // ... if it is bigger take the right child node...
+            else if (isLess(current->getPayload(), item) == true) {
+                current = current->getRightChild();
+            } else {
+                recordLookup(depth);
+                return current;
+            }
+        }
+        recordLookup(depth);
+        return nullptr;
+    }
+
+    void recordLookup(uint32_t depth) const {
+        if constexpr (Options::statistics) {
+            _stats.recordLookup(depth);
+        } else {
+            (void)depth;
+        }
+    }
+
+    // Links the new node insertee into the tree, attach places it as leaf
+    // below a non empty tree
+    template <class Attach>
+    iterator insertNode(node_type* insertee, Attach attach) {
+        if constexpr (Options::statistics) ++_stats.inserts;
+        if (_root == nullptr) {  // Tree is empty so insert new node as root
+            _root = insertee;
+        } else {
+            try {
+                attach();
+            } catch (...) {
+                _alloc.destroy(insertee);
+                throw;
+            }
+            threadLeaf(insertee);
+            // The new parent is up to date already, the ancestors above not
+            adjustSubtreeSizes(insertee->getParent()->getParent(), 1);
 #ifdef _AE_TREE_DEBUGMODE_
-                    if (_dbgcb) _dbgcb(*this, "post_leftRightRotateSubtree", iterator(newRoot));
+            if (_dbgcb) _dbgcb(*this, "post_insert", iterator(insertee));
 #endif
-                } else {
-                    newRoot = TreeHelper<T>::leftRotateSubtree(node);
-                    updateParent(parent, node, newRoot);
+            rebalanceAfterInsert(insertee->getParent());
+        }
+        ++_size;
 #ifdef _AE_TREE_DEBUGMODE_
-                    if (_dbgcb) _dbgcb(*this, "post_leftRotateSubtree", iterator(newRoot));
+        if (_dbgcb) _dbgcb(*this, "post_insert_and_balance", end());
 #endif
+        return iterator(insertee);
+    }
+
+    // Climbs from node towards the root until reaching a subtree whose range
+    // of items includes item. Only ancestors bounding the subtree on the side
+    // of item are compared.
+    template <class K>
+    node_type* climbFrom(node_type* node, const K& item) const {
+        bool greater = isLess(node->getPayload(), item);
+        for (node_type* parent = node->getParent(); parent != nullptr; parent = node->getParent()) {
+            bool isLeftChild = (parent->getLeftChild() == node);
+            if (greater && isLeftChild && isLess(item, parent->getPayload()) == true) break;
+            if (!greater && !isLeftChild && isLess(parent->getPayload(), item) == true) break;
+            node = parent;
+        }
+        return node;
+    }
+
+    // Links insertee as leaf next to hint. If it does not belong right
+    // before or behind hint, it is attached below the subtree found by
+    // climbing from the neighbour of hint closer to it.
+    void attachLeafNear(node_type* insertee, node_type* hint) {
+        const T& item = insertee->getPayload();
+        node_type* before = (hint != nullptr) ? (--iterator(hint))._current : getRightMostNode(_root);
+        node_type* after = hint;
+        if (after != nullptr && isLess(after->getPayload(), item) == true) {
+            before = after;
+            after = (++iterator(after))._current;
+            if (after != nullptr && isLess(after->getPayload(), item) == true) {
+                attachLeaf(insertee, climbFrom(after, item));
+                return;
+            }
+        } else if (before != nullptr && isLess(item, before->getPayload()) == true) {
+            attachLeaf(insertee, climbFrom(before, item));
+            return;
+        }
+
+        // The predecessor of a node with a left child is the rightmost node
+        // of that subtree, so one of both positions is free
+        if (after != nullptr && after->getLeftChild() == nullptr) {
+            insertee->setParent(after);
+            after->setLeftChild(insertee);
+        } else {
+            insertee->setParent(before);
+            before->setRightChild(insertee);
+        }
+    }
+
+    // Walks down from start and links insertee as new leaf at its sorted
+    // position. Heights and balance are not touched beyond the new parent.
+    void attachLeaf(node_type* insertee, node_type* start) {
+        node_type* current = start;
+        while (true) {
+            if (isLess(insertee->getPayload(), current->getPayload()) == true) {
+                // Check if the left child node exists already
+                if (current->getLeftChild() == nullptr) {
+                    // If it does not, add the new node exactly here
+                    insertee->setParent(current);
+                    current->setLeftChild(insertee);
+                    return;
+                }
+                // If it does, follow this branch
+                current = current->getLeftChild();
+            } else {
+                // Check if the right child node exists already
+                if (current->getRightChild() == nullptr) {
+                    // If it does not, add the new node exactly here
+                    insertee->setParent(current);
+                    current->setRightChild(insertee);
+                    return;
                 }
-            } else if (nodeBalance < -1) {
-                if (node->getLeftChild()->getBalance() > 0) {
-                    newRoot = TreeHelper<T>::rightLeftRotateSubtree(node);
-                    updateParent(parent, node, newRoot);
+                // If it does, follow this branch
+                current = current->getRightChild();
+            }
+        }
+    }
+
+    // Retraces towards the root from the parent of a freshly attached leaf,
+    // which is up to date already. Once the grown child stays lower than its
+    // parent, the height of the parent is unchanged and nothing above can be
+    // affected. A rotation restores the height the subtree had before the
+    // insertion, so at most one (double) rotation is done per insert. Ranks
+    // of WavlBalance grow exactly like heights here.
+    void rebalanceAfterInsert(node_type* child) {
+        node_type* node = child->getParent();
+        while (node != nullptr) {
+            if constexpr (Options::statistics) ++_stats.rebalanceSteps;
+            if (child->getHeight() < node->getHeight()) return;
+            node->updateMetaData();
+            if (!isBalanced(node)) {
+                rotate(node);
+                return;
+            }
+            child = node;
+            node = node->getParent();
+        }
+    }
+
+    // Retraces from the parent of a removed node towards the root.
+    // oldHeight is the height node had before the removal. Unlike insertion
+    // a rotation may shrink the subtree, so retracing only stops once a
+    // subtree keeps its previous height.
+    void rebalanceAfterErase(node_type* node, uint32_t oldHeight) {
+        if constexpr (Balance::rankBalanced) {
+            // Unlinking the child recalculated the rank, which is restored
+            // to let demoteAfterErase() decide
+            if (node != nullptr) node->setHeight(oldHeight);
+            demoteAfterErase(node);
+            return;
+        }
+        while (node != nullptr) {
+            if constexpr (Options::statistics) ++_stats.rebalanceSteps;
+            node_type* parent = node->getParent();
+            uint32_t oldParentHeight = (parent != nullptr) ? parent->getHeight() : 0;
+
+            node->updateMetaData();
+            if (!isBalanced(node)) node = rotate(node);
+            if (node->getHeight() == oldHeight) return;
+
+            node = parent;
+            oldHeight = oldParentHeight;
+        }
+    }
+
+    // Restores the rank rule of WavlBalance from node upwards after one child
+    // of node lost a rank, or a leaf of rank 2 was left behind. A node whose
+    // child fell three ranks below is demoted, along with its sibling if that
+    // has both children two ranks below, and the walk goes on at its parent.
+    // Otherwise a single or double rotation ends the walk, so erase does at
+    // most two rotations.
+    void demoteAfterErase(node_type* node) {
+        while (node != nullptr) {
+            if constexpr (Options::statistics) ++_stats.rebalanceSteps;
+            uint32_t rank = node->getHeight();
+            node_type* left = node->getLeftChild();
+            node_type* right = node->getRightChild();
+            if (left == nullptr && right == nullptr) {
+                if (rank == 1) return;
+                node->setHeight(1);
+            } else if (rank - heightOf(left) == 3 || rank - heightOf(right) == 3) {
+                node_type* sibling = (rank - heightOf(left) == 3) ? right : left;
+                if (rank - sibling->getHeight() == 2) {
+                    node->setHeight(rank - 1);
+                } else if (sibling->getHeight() - heightOf(sibling->getLeftChild()) == 2 &&
+                           sibling->getHeight() - heightOf(sibling->getRightChild()) == 2) {
+                    sibling->setHeight(sibling->getHeight() - 1);
+                    node->setHeight(rank - 1);
+                } else {
+                    // The sibling leans away from the short child or not at
+                    // all, which rotate() resolves by a single rotation
+                    node_type* top = rotate(node);
+                    top->setHeight(rank);
+                    if (top == sibling) {
+                        bool leaf = node->getLeftChild() == nullptr && node->getRightChild() == nullptr;
+                        node->setHeight(leaf ? 1 : rank - 1);
+                    } else {
+                        node->setHeight(rank - 2);
+                        sibling->setHeight(rank - 2);
+                    }
+                    return;
+                }
+            } else {
+                return;
+            }
+            node = node->getParent();
+        }
+    }
+
+    // Rotates the subtree rooted at node, whose balance must be out of the
+    // range allowed by the balancing policy, and returns the new root of the
+    // subtree.
+    node_type* rotate(node_type* node) {
+        if constexpr (Options::statistics) ++_stats.rotations;
+        node_type* parent = node->getParent();
+        node_type* newRoot = nullptr;
+
+        if (node->getBalance() > 1) {
+            if (node->getRightChild()->getBalance() < 0) {
+                newRoot = TreeHelper<T, Options>::leftRightRotateSubtree(node);
+                updateParent(parent, node, newRoot);
 #ifdef _AE_TREE_DEBUGMODE_
-                    if (_dbgcb) _dbgcb(*this, "post_rightLeftRotateSubtree", iterator(newRoot));
+                if (_dbgcb) _dbgcb(*this, "post_leftRightRotateSubtree", iterator(newRoot));
 #endif
-                } else {
-                    newRoot = TreeHelper<T>::rightRotateSubtree(node);
-                    updateParent(parent, node, newRoot);
+            } else {
+                newRoot = TreeHelper<T, Options>::leftRotateSubtree(node);
+                updateParent(parent, node, newRoot);
 #ifdef _AE_TREE_DEBUGMODE_
-                    if (_dbgcb) _dbgcb(*this, "post_rightRotateSubtree", iterator(newRoot));
+                if (_dbgcb) _dbgcb(*this, "post_leftRotateSubtree", iterator(newRoot));
 #endif
-                }
             }
-            if (newRoot != nullptr) {
-                node = newRoot->getParent();
+        } else {
+            if (node->getLeftChild()->getBalance() > 0) {
+                newRoot = TreeHelper<T, Options>::rightLeftRotateSubtree(node);
+                updateParent(parent, node, newRoot);
+#ifdef _AE_TREE_DEBUGMODE_
+                if (_dbgcb) _dbgcb(*this, "post_rightLeftRotateSubtree", iterator(newRoot));
+#endif
             } else {
-                node = node->getParent();
+                newRoot = TreeHelper<T, Options>::rightRotateSubtree(node);
+                updateParent(parent, node, newRoot);
+#ifdef _AE_TREE_DEBUGMODE_
+                if (_dbgcb) _dbgcb(*this, "post_rightRotateSubtree", iterator(newRoot));
+#endif
             }
         }
+        return newRoot;
     }
 
-    void updateParent(Node<T>* parent, Node<T>* oldRoot, Node<T>* newRoot) {
+    void updateParent(node_type* parent, node_type* oldRoot, node_type* newRoot) {
         if (parent == nullptr) {
             newRoot->makeRoot();
             _root = newRoot;
         } else {
+            // A rotation keeps the rank of the subtree, so the parent keeps
+            // its rank as well, which may exceed its recalculated height
+            uint32_t parentHeight = parent->getHeight();
             if (parent->getLeftChild() == oldRoot) {
                 newRoot->setParent(parent);
                 parent->setLeftChild(newRoot);
@@ -335,14 +1636,40 @@ class Tree {
                 newRoot->setParent(parent);
                 parent->setRightChild(newRoot);
             }
+            if constexpr (Balance::rankBalanced) parent->setHeight(parentHeight);
         }
     }
 
-    Node<T>* _root;
-    std::function<bool(T, T)> _comp;
+    node_type* _root;
+    allocator_type _alloc;
+    Compare _comp;
 #ifdef _AE_TREE_DEBUGMODE_
-    std::function<void(const Tree<T>&, std::string, iterator)> _dbgcb;
+    std::function<void(const Tree&, std::string, iterator)> _dbgcb;
 #endif
     std::size_t _size;
+    mutable std::conditional_t<Options::statistics, TreeStatistics, NoTreeStatistics> _stats;
 };
+
+// Tree that additionally stores subtree sizes in its nodes to support
+// select(), rank() and count_range() in O(log n)
+template <class T, class Compare = std::less<>, template <class> class Allocator = HeapNodeAllocator>
+using OrderStatisticTree = Tree<T, Compare, Allocator, TreeOptions<SubtreeSize>>;
+
+// Tree counting what its operations cost, see TreeStatistics
+template <class T, class Compare = std::less<>, template <class> class Allocator = HeapNodeAllocator>
+using InstrumentedTree = Tree<T, Compare, Allocator, TreeOptions<Statistics>>;
+
+// Tree whose iterators step to the next and previous item in O(1)
+template <class T, class Compare = std::less<>, template <class> class Allocator = HeapNodeAllocator>
+using ThreadedTree = Tree<T, Compare, Allocator, TreeOptions<Threaded>>;
+
+// Tree whose subtree heights may differ by up to two, trading a little
+// lookup speed for fewer rotations on insert and erase, see HeightBalance
+template <class T, class Compare = std::less<>, template <class> class Allocator = HeapNodeAllocator>
+using RelaxedTree = Tree<T, Compare, Allocator, TreeOptions<NoFeatures, HeightBalance<2>>>;
+
+// Tree doing O(1) amortized rotations and rank changes per erase, for erase
+// heavy workloads, see WavlBalance
+template <class T, class Compare = std::less<>, template <class> class Allocator = HeapNodeAllocator>
+using WavlTree = Tree<T, Compare, Allocator, TreeOptions<NoFeatures, WavlBalance>>;
 }  // namespace base
@@ -27,7 +27,7 @@
 #include "node.h"
 
 namespace base {
-template <class T>
+template <class T, class Options = TreeOptions<>>
 class TreeHelper {
    public:
     /* What is done:
@@ -48,9 +48,9 @@ class TreeHelper {
      * root must be a right heavy subtree with an existing
      * right child (must not be null!!!)
      */
-    static Node<T>* leftRotateSubtree(Node<T>* root) {
-        Node<T>* r1 = root->getRightChild();
-        Node<T>* rl2 = r1->getLeftChild();
+    static Node<T, Options>* leftRotateSubtree(Node<T, Options>* root) {
+        Node<T, Options>* r1 = root->getRightChild();
+        Node<T, Options>* rl2 = r1->getLeftChild();
         if (rl2 != nullptr) rl2->setParent(root);
         root->setRightChild(rl2);
         // We need to temporarily set null as parent to r1
@@ -84,9 +84,9 @@ class TreeHelper {
      * root must be a left heavy subtree with an existing
      * left child (must not be null!!!)
      */
-    static Node<T>* rightRotateSubtree(Node<T>* root) {
-        Node<T>* l1 = root->getLeftChild();
-        Node<T>* lr2 = l1->getRightChild();
+    static Node<T, Options>* rightRotateSubtree(Node<T, Options>* root) {
+        Node<T, Options>* l1 = root->getLeftChild();
+        Node<T, Options>* lr2 = l1->getRightChild();
         if (lr2 != nullptr) lr2->setParent(root);
         root->setLeftChild(lr2);
         // We need to temporarily set null as parent to l1
@@ -106,8 +106,8 @@ class TreeHelper {
     // root must be a right heavy subtree with an existing
     // right child (must not be null!!!) which is left heavy
     // and must have an existing left child
-    static Node<T>* leftRightRotateSubtree(Node<T>* root) {
-        Node<T>* newRoot = root->getRightChild();
+    static Node<T, Options>* leftRightRotateSubtree(Node<T, Options>* root) {
+        Node<T, Options>* newRoot = root->getRightChild();
         newRoot = rightRotateSubtree(newRoot);
         if (newRoot != nullptr) newRoot->setParent(root);
         root->setRightChild(newRoot);
@@ -118,22 +118,14 @@ class TreeHelper {
     // root must be a left heavy subtree with an existing
     // left child (must not be null!!!) which is right heavy
     // and must have an existing right child
-    static Node<T>* rightLeftRotateSubtree(Node<T>* root) {
-        Node<T>* newRoot = root->getLeftChild();
+    static Node<T, Options>* rightLeftRotateSubtree(Node<T, Options>* root) {
+        Node<T, Options>* newRoot = root->getLeftChild();
         newRoot = leftRotateSubtree(newRoot);
         if (newRoot != nullptr) newRoot->setParent(root);
         root->setLeftChild(newRoot);
         return rightRotateSubtree(root);
     }
 
-    static void recursiveDestroyNode(Node<T>* node) {
-        if (node == nullptr) return;
-
-        recursiveDestroyNode(node->getLeftChild());
-        recursiveDestroyNode(node->getRightChild());
-        delete node;
-    }
-
    private:
     TreeHelper() = delete;
     ~TreeHelper() = delete;
@@ -0,0 +1,137 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <base/helpers.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "treeimageheader.h"
+
+namespace base {
+/**
+ * @brief      Read only view on a tree image file written by Tree::save()
+ *
+ * The file is mapped into memory and the items are used in place as a
+ * sorted array, so opening takes O(1) no matter how many items there are.
+ * Pages are only read from disk once they are accessed. Lookups are binary
+ * searches. Use loadTreeImage() to get a modifiable tree out of the image.
+ */
+template <class T, class Compare = std::less<>>
+class TreeImage : public NONCOPYANDMOVEABLE {
+    static_assert(std::is_trivially_copyable_v<T>, "TreeImage maps raw items, T must be trivially copyable");
+
+   public:
+    typedef const T* iterator;
+
+    explicit TreeImage(const std::filesystem::path& path, Compare compare = Compare())
+        : _mapping(nullptr), _mappingSize(0), _items(nullptr), _count(0), _comp(std::move(compare)) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open tree image " + path.string());
+        struct stat status;
+        if (::fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(TreeImageHeader))) {
+            ::close(fd);
+            throw std::runtime_error("Tree image is truncated, header incomplete");
+        }
+        _mappingSize = static_cast<std::size_t>(status.st_size);
+        _mapping = ::mmap(nullptr, _mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (_mapping == MAP_FAILED) throw std::runtime_error("Cannot map tree image " + path.string());
+
+        try {
+            TreeImageHeader header;
+            std::memcpy(&header, _mapping, sizeof(TreeImageHeader));
+            header.check(sizeof(T));
+            // The writer aligns the items, a foreign image must not make them misaligned
+            if (header.itemOffset % alignof(T) != 0) throw std::runtime_error("Tree image has misaligned items");
+            if ((_mappingSize - std::min<std::size_t>(_mappingSize, header.itemOffset)) / sizeof(T) < header.count) {
+                throw std::runtime_error("Tree image is truncated, items incomplete");
+            }
+            _items = reinterpret_cast<const T*>(static_cast<const char*>(_mapping) + header.itemOffset);
+            _count = static_cast<std::size_t>(header.count);
+        } catch (...) {
+            ::munmap(_mapping, _mappingSize);
+            throw;
+        }
+    }
+
+    ~TreeImage() { ::munmap(_mapping, _mappingSize); }
+
+    // Returns an iterator to the first item comparing equal to key or end()
+    template <class K>
+    iterator find(const K& key) const {
+        iterator it = lower_bound(key);
+        return (it != end() && !_comp(key, *it)) ? it : end();
+    }
+
+    template <class K>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    template <class K>
+    iterator lower_bound(const K& key) const {
+        return std::lower_bound(begin(), end(), key, _comp);
+    }
+
+    template <class K>
+    iterator upper_bound(const K& key) const {
+        return std::upper_bound(begin(), end(), key, _comp);
+    }
+
+    iterator begin() const { return _items; }
+
+    iterator end() const { return _items + _count; }
+
+    std::size_t size() const { return _count; }
+
+    bool empty() const { return _count == 0; }
+
+   private:
+    void* _mapping;
+    std::size_t _mappingSize;
+    const T* _items;
+    std::size_t _count;
+    Compare _comp;
+};
+
+// Replaces the content of tree by a copy of the items of a mapped image. They
+// are checked to be in order and built into a perfectly balanced tree in O(n)
+// without a single rotation, see Tree::assign().
+template <class TreeType, class T, class Compare>
+void loadTreeImage(TreeType& tree, const TreeImage<T, Compare>& image) {
+    tree.assign(image.begin(), image.end());
+}
+}  // namespace base
@@ -0,0 +1,91 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace base {
+// Header of the binary image written by Tree::save(). The items follow in
+// order, either as raw bytes at itemOffset, or encoded by a user provided
+// writer directly behind the header with an itemSize of 0.
+struct TreeImageHeader {
+    static constexpr char MAGIC[8] = {'A', 'E', 'T', 'R', 'E', 'E', '\0', '\1'};
+
+    char magic[8];
+    uint32_t itemSize;
+    uint32_t itemOffset;
+    uint64_t count;
+
+    // Raw items start at the next multiple of their alignment, so they can
+    // be used in place from a page aligned mapping
+    template <class T>
+    static TreeImageHeader forRawItems(uint64_t count) {
+        std::size_t offset = (sizeof(TreeImageHeader) + alignof(T) - 1) / alignof(T) * alignof(T);
+        return TreeImageHeader{{}, static_cast<uint32_t>(sizeof(T)), static_cast<uint32_t>(offset), count}.stamped();
+    }
+
+    static TreeImageHeader forEncodedItems(uint64_t count) {
+        return TreeImageHeader{{}, 0, static_cast<uint32_t>(sizeof(TreeImageHeader)), count}.stamped();
+    }
+
+    void write(std::ostream& out) const {
+        out.write(reinterpret_cast<const char*>(this), sizeof(TreeImageHeader));
+        for (std::size_t i = sizeof(TreeImageHeader); i < itemOffset; ++i) out.put('\0');
+    }
+
+    // Reads a header and skips the padding up to the items. expectedItemSize
+    // is sizeof(T) for raw and 0 for encoded items.
+    static TreeImageHeader read(std::istream& in, uint32_t expectedItemSize) {
+        TreeImageHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(TreeImageHeader))) {
+            throw std::runtime_error("Tree image is truncated, header incomplete");
+        }
+        header.check(expectedItemSize);
+        in.ignore(header.itemOffset - sizeof(TreeImageHeader));
+        return header;
+    }
+
+    void check(uint32_t expectedItemSize) const {
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) throw std::runtime_error("Not a tree image");
+        if (itemSize != expectedItemSize) {
+            throw std::runtime_error("Tree image holds items of size " + std::to_string(itemSize) + " instead of " +
+                                     std::to_string(expectedItemSize));
+        }
+        if (itemOffset < sizeof(TreeImageHeader)) throw std::runtime_error("Tree image has a broken item offset");
+    }
+
+   private:
+    TreeImageHeader stamped() const {
+        TreeImageHeader header = *this;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        return header;
+    }
+};
+}  // namespace base
@@ -0,0 +1,255 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "nodeallocator.h"
+#include "tree.h"
+
+namespace base {
+// Iterator over the key/value pairs of a TreeMap. Value is const for a
+// const_iterator.
+template <class TreeIterator, class Value>
+class TreeMapIterator {
+   public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef std::remove_const_t<Value> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Value* pointer;
+    typedef Value& reference;
+
+    TreeMapIterator() : _it() {}
+    explicit TreeMapIterator(TreeIterator it) : _it(it) {}
+
+    // Every iterator converts into a const_iterator
+    template <class Other, typename = std::enable_if_t<std::is_same_v<const Other, Value>>>
+    TreeMapIterator(const TreeMapIterator<TreeIterator, Other>& other) : _it(other.base()) {}
+
+    // The tree only hands out const payloads. The payload inside the node
+    // is not const itself, so the value may be changed through it. The key
+    // stays const and so does the order.
+    Value& operator*() const { return const_cast<Value&>(*_it); }
+
+    Value* operator->() const { return &operator*(); }
+
+    bool operator==(const TreeMapIterator& other) const { return _it == other._it; }
+
+    bool operator!=(const TreeMapIterator& other) const { return !operator==(other); }
+
+    const TreeMapIterator& operator++() {
+        ++_it;
+        return *this;
+    }
+
+    const TreeMapIterator& operator--() {
+        --_it;
+        return *this;
+    }
+
+    const TreeMapIterator operator++(int) {
+        TreeMapIterator temp(*this);
+        ++(*this);
+        return temp;
+    }
+
+    const TreeMapIterator operator--(int) {
+        TreeMapIterator temp(*this);
+        --(*this);
+        return temp;
+    }
+
+    TreeIterator base() const { return _it; }
+
+   private:
+    TreeIterator _it;
+};
+
+/**
+ * @brief      Sorted map from unique keys to values on top of Tree
+ *
+ * The items are std::pair<const K, V> like in std::map. Only the keys are
+ * compared, by reference, and the values can be changed in place through
+ * the iterators. operator[] and try_emplace() descend only once and
+ * construct the item only if the key is missing.
+ */
+template <class K, class V, class Compare = std::less<>, template <class> class Allocator = HeapNodeAllocator>
+class TreeMap {
+   public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const K, V> value_type;
+    typedef Compare key_compare;
+
+   private:
+    // Compares items by their keys and keys with items for the lookups
+    class KeyCompare {
+       public:
+        typedef void is_transparent;
+
+        KeyCompare() : _comp() {}
+        explicit KeyCompare(Compare compare) : _comp(std::move(compare)) {}
+
+        bool operator()(const value_type& lhs, const value_type& rhs) const { return _comp(lhs.first, rhs.first); }
+
+        template <class L>
+        bool operator()(const L& lhs, const value_type& rhs) const {
+            return _comp(lhs, rhs.first);
+        }
+
+        template <class R>
+        bool operator()(const value_type& lhs, const R& rhs) const {
+            return _comp(lhs.first, rhs);
+        }
+
+       private:
+        Compare _comp;
+    };
+
+    typedef Tree<value_type, KeyCompare, Allocator> tree_type;
+
+   public:
+    typedef TreeMapIterator<typename tree_type::iterator, value_type> iterator;
+    typedef TreeMapIterator<typename tree_type::iterator, const value_type> const_iterator;
+
+    TreeMap() : _tree() {}
+    explicit TreeMap(Compare compare) : _tree(KeyCompare(std::move(compare))) {}
+
+    // Inserts a value constructed from args if key is missing. Returns the
+    // item with key and whether it was inserted.
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        return wrap(_tree.try_emplace(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                      std::forward_as_tuple(std::forward<Args>(args)...)));
+    }
+
+    // key is only moved from if it is inserted
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        return wrap(_tree.try_emplace(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                      std::forward_as_tuple(std::forward<Args>(args)...)));
+    }
+
+    std::pair<iterator, bool> insert(const value_type& item) { return wrap(_tree.try_emplace(item.first, item)); }
+
+    std::pair<iterator, bool> insert(value_type&& item) {
+        return wrap(_tree.try_emplace(item.first, std::move(item)));
+    }
+
+    // Inserts the value or assigns it to the value of an existing key
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        std::pair<iterator, bool> result = try_emplace(key, std::forward<M>(value));
+        // value was not moved from if nothing got inserted
+        if (!result.second) result.first->second = std::forward<M>(value);
+        return result;
+    }
+
+    // Value of key, which is inserted with a value initialized value first
+    // if it is missing
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+    V& at(const K& key) { return checkedValue(find(key)); }
+
+    const V& at(const K& key) const { return checkedValue(find(key)); }
+
+    iterator find(const K& key) { return iterator(_tree.find(key)); }
+
+    const_iterator find(const K& key) const { return const_iterator(_tree.find(key)); }
+
+    // Heterogeneous lookup, only available for a transparent Compare
+    template <class L, class C = Compare, typename = typename C::is_transparent>
+    iterator find(const L& key) {
+        return iterator(_tree.find(key));
+    }
+
+    template <class L, class C = Compare, typename = typename C::is_transparent>
+    const_iterator find(const L& key) const {
+        return const_iterator(_tree.find(key));
+    }
+
+    bool contains(const K& key) const { return _tree.contains(key); }
+
+    template <class L, class C = Compare, typename = typename C::is_transparent>
+    bool contains(const L& key) const {
+        return _tree.contains(key);
+    }
+
+    // Returns an iterator to the first item whose key is not less than key
+    iterator lower_bound(const K& key) { return iterator(_tree.lower_bound(key)); }
+
+    const_iterator lower_bound(const K& key) const { return const_iterator(_tree.lower_bound(key)); }
+
+    // Returns an iterator to the first item whose key is greater than key
+    iterator upper_bound(const K& key) { return iterator(_tree.upper_bound(key)); }
+
+    const_iterator upper_bound(const K& key) const { return const_iterator(_tree.upper_bound(key)); }
+
+    // Removes the item at position and returns the item behind it. The tree
+    // relinks its nodes on erase and never moves the pairs with their const
+    // keys, iterators to all other items stay valid.
+    iterator erase(const_iterator position) { return iterator(_tree.erase(position.base())); }
+
+    // Removes the item with key if there is one and returns the number of
+    // removed items
+    std::size_t erase(const K& key) { return _tree.erase(key); }
+
+    iterator begin() { return iterator(_tree.begin()); }
+
+    iterator end() { return iterator(_tree.end()); }
+
+    const_iterator begin() const { return const_iterator(_tree.begin()); }
+
+    const_iterator end() const { return const_iterator(_tree.end()); }
+
+    std::size_t size() const { return _tree.size(); }
+
+    bool empty() const { return _tree.empty(); }
+
+    void clear() { _tree.clear(); }
+
+    uint32_t getHeight() const { return _tree.getHeight(); }
+
+   private:
+    static std::pair<iterator, bool> wrap(std::pair<typename tree_type::iterator, bool> result) {
+        return std::make_pair(iterator(result.first), result.second);
+    }
+
+    template <class It>
+    static auto& checkedValue(It position) {
+        if (position == It()) throw std::out_of_range("TreeMap::at() called for a missing key");
+        return position->second;
+    }
+
+    tree_type _tree;
+};
+}  // namespace base
@@ -0,0 +1,90 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace base {
+// Optional augmentations of the tree nodes. Features can be combined with |.
+// Every feature costs memory in each node and time to keep it up to date, so
+// only the plain AVL tree is built by default.
+enum TreeFeature : unsigned {
+    NoFeatures = 0,
+    // Every node stores the number of nodes in its subtree, which enables
+    // the order statistic functions select(), rank() and count_range()
+    SubtreeSize = 1u << 0,
+    // Every node links to its in-order predecessor and successor, so
+    // iterators step in O(1) without walking up the tree
+    Threaded = 1u << 1,
+    // The tree counts comparisons, rotations and lookup depths, see
+    // TreeStatistics
+    Statistics = 1u << 2,
+};
+
+// Balancing policy of a height balanced tree: the heights of the two
+// subtrees of every node differ by at most MaxImbalance. 1 is the classic
+// AVL tree with the lowest height and the fastest lookups. Larger values
+// let the tree grow higher, still logarithmic in the number of items, but
+// need fewer rotations and shorter retracing on insert and erase, which
+// pays off for update heavy workloads.
+template <uint32_t MaxImbalance>
+struct HeightBalance {
+    static_assert(MaxImbalance >= 1, "A node with a single child is already out of balance by one");
+
+    static constexpr int32_t maxImbalance = MaxImbalance;
+    // Nodes store their exact height
+    static constexpr bool rankBalanced = false;
+
+    static bool isBalanced(int32_t balance) { return balance <= maxImbalance && balance >= -maxImbalance; }
+};
+
+typedef HeightBalance<1> AvlBalance;
+
+// Weak AVL balancing policy. Nodes store a rank instead of the height: the
+// rank of a node exceeds the ranks of its children by one or two, and
+// leaves have rank 1. Inserting behaves exactly like in an AVL tree, but
+// erasing demotes ranks instead of rotating wherever it can and stops at
+// nodes whose children both end up two ranks below. So erase does at most
+// two rotations and O(1) rank changes amortized, at the price of a height
+// of up to 2 log(n) after many erases. The ranks of siblings differ by at
+// most one, which lets split, join and the set operations treat them like
+// AVL heights.
+struct WavlBalance {
+    static constexpr int32_t maxImbalance = 1;
+    // Nodes store ranks, which may exceed their height
+    static constexpr bool rankBalanced = true;
+
+    static bool isBalanced(int32_t balance) { return balance <= 1 && balance >= -1; }
+};
+
+template <unsigned Features = NoFeatures, class Balance = AvlBalance>
+struct TreeOptions {
+    typedef Balance balance_policy;
+    static constexpr unsigned features = Features;
+    static constexpr bool subtreeSize = (Features & SubtreeSize) != 0;
+    static constexpr bool threaded = (Features & Threaded) != 0;
+    static constexpr bool statistics = (Features & Statistics) != 0;
+};
+}  // namespace base
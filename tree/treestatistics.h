@@ -0,0 +1,74 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace base {
+// Counters of a tree with TreeFeature::Statistics. Counting is not
+// synchronized, so such a tree must not be read from several threads at
+// once. Its parallel operations run on the calling thread only.
+struct TreeStatistics {
+    uint64_t inserts = 0;
+    uint64_t erases = 0;
+    uint64_t lookups = 0;
+    // Calls of the comparison function by any operation
+    uint64_t comparisons = 0;
+    // Single and double rotations done to rebalance after insert and erase
+    uint64_t rotations = 0;
+    // Nodes visited while retracing towards the root after insert and erase
+    uint64_t rebalanceSteps = 0;
+    // lookupDepths[d] is the number of lookups that compared with d nodes
+    std::vector<uint64_t> lookupDepths;
+
+    void recordLookup(uint32_t depth) {
+        ++lookups;
+        if (lookupDepths.size() <= depth) lookupDepths.resize(depth + 1, 0);
+        ++lookupDepths[depth];
+    }
+
+    double averageLookupDepth() const {
+        if (lookups == 0) return 0.0;
+        uint64_t total = 0;
+        for (std::size_t depth = 0; depth < lookupDepths.size(); ++depth) total += depth * lookupDepths[depth];
+        return static_cast<double>(total) / static_cast<double>(lookups);
+    }
+};
+
+// Used instead of TreeStatistics without TreeFeature::Statistics
+struct NoTreeStatistics {};
+
+inline std::ostream& operator<<(std::ostream& out, const TreeStatistics& stats) {
+    out << "Inserts: " << stats.inserts << ", erases: " << stats.erases << ", lookups: " << stats.lookups << '\n';
+    out << "Comparisons: " << stats.comparisons << ", rotations: " << stats.rotations
+        << ", rebalance steps: " << stats.rebalanceSteps << '\n';
+    out << "Lookup depths (average " << stats.averageLookupDepth() << "):";
+    for (std::size_t depth = 0; depth < stats.lookupDepths.size(); ++depth) {
+        if (stats.lookupDepths[depth] != 0) out << ' ' << depth << ':' << stats.lookupDepths[depth];
+    }
+    return out << '\n';
+}
+}  // namespace base
@@ -38,3 +38,60 @@ extern const int TEST_DESCENDING_INTS[10];
 // TODO: Make usage of graphviz optional and make the location of the executable
 // configurable
 extern void genPngImage(const base::Tree<int>& tree, std::string text, base::Tree<int>::iterator it);
+
+// Checks parent links, stored heights and AVL balance of the subtree below
+// node. Returns the height of the subtree or -1 if any invariant is broken.
+// Trees with a relaxed HeightBalance policy pass their maxImbalance.
+template <class NodeT>
+int32_t checkAvlSubtree(NodeT* node, int32_t maxImbalance = 1) {
+    if (node == nullptr) return 0;
+
+    NodeT* lc = node->getLeftChild();
+    NodeT* rc = node->getRightChild();
+    if (lc != nullptr && lc->getParent() != node) return -1;
+    if (rc != nullptr && rc->getParent() != node) return -1;
+
+    int32_t lh = checkAvlSubtree(lc, maxImbalance);
+    int32_t rh = checkAvlSubtree(rc, maxImbalance);
+    if (lh < 0 || rh < 0) return -1;
+    if (rh - lh > maxImbalance || lh - rh > maxImbalance) return -1;
+
+    int32_t height = std::max(lh, rh) + 1;
+    if (static_cast<int32_t>(node->getHeight()) != height) return -1;
+    return height;
+}
+
+// Checks parent links and the rank rule of WavlBalance for the subtree below
+// node: rank differences of one or two and leaves of rank 1. Returns the
+// rank of node or -1 if any invariant is broken.
+template <class NodeT>
+int32_t checkWavlSubtree(NodeT* node) {
+    if (node == nullptr) return 0;
+
+    NodeT* lc = node->getLeftChild();
+    NodeT* rc = node->getRightChild();
+    if (lc != nullptr && lc->getParent() != node) return -1;
+    if (rc != nullptr && rc->getParent() != node) return -1;
+
+    int32_t lr = checkWavlSubtree(lc);
+    int32_t rr = checkWavlSubtree(rc);
+    if (lr < 0 || rr < 0) return -1;
+
+    int32_t rank = static_cast<int32_t>(node->getHeight());
+    if (lc == nullptr && rc == nullptr) return (rank == 1) ? rank : -1;
+    if (rank - lr < 1 || rank - lr > 2 || rank - rr < 1 || rank - rr > 2) return -1;
+    return rank;
+}
+
+// Returns the number of nodes below node or -1 if any stored subtree size
+// does not match. Only for trees with TreeFeature::SubtreeSize.
+template <class NodeT>
+int64_t checkSubtreeSizes(NodeT* node) {
+    if (node == nullptr) return 0;
+
+    int64_t left = checkSubtreeSizes(node->getLeftChild());
+    int64_t right = checkSubtreeSizes(node->getRightChild());
+    if (left < 0 || right < 0) return -1;
+    if (static_cast<int64_t>(node->getSubtreeSize()) != left + right + 1) return -1;
+    return left + right + 1;
+}
@@ -0,0 +1,245 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/btree.h>
+
+#include "CommonData.h"
+
+namespace {
+// Few items per node to get deep trees with small numbers of items
+typedef base::BTree<int, 64> SmallNodeTree;
+
+template <class TreeType>
+std::vector<int> toVector(const TreeType& tree) {
+    return std::vector<int>(tree.begin(), tree.end());
+}
+}  // namespace
+
+TEST(UT018BTree, EmptyTree_NoItems) {
+    base::BTree<int> tree;
+
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(0u, tree.size());
+    EXPECT_EQ(0u, tree.getHeight());
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_TRUE(tree.find(1) == tree.end());
+    EXPECT_FALSE(tree.contains(1));
+    EXPECT_TRUE(tree.checkStructure());
+}
+
+TEST(UT018BTree, NodeCapacity_DerivedFromNodeBytes) {
+    EXPECT_EQ(56u, (base::BTree<int, 256>::LEAF_CAPACITY));
+    EXPECT_EQ(19u, (base::BTree<int, 256>::INNER_CAPACITY));
+    EXPECT_EQ(4u, (base::BTree<std::string, 64>::LEAF_CAPACITY));
+    EXPECT_EQ(4u, (base::BTree<int, 16>::LEAF_CAPACITY));
+    EXPECT_EQ(4u, (base::BTree<int, 16>::INNER_CAPACITY));
+}
+
+TEST(UT018BTree, NodeBytesBelowHeader_MinimumCapacityStillWorks) {
+    base::BTree<int, 8> tree;
+    for (int i = 0; i < 100; ++i) tree.insert(99 - i);
+
+    EXPECT_TRUE(tree.checkStructure());
+    EXPECT_EQ(100u, tree.size());
+    EXPECT_EQ(0, *tree.begin());
+}
+
+TEST(UT018BTree, InsertTestData_IteratesSortedWithValidStructure) {
+    SmallNodeTree tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
+        tree.insert(TEST_UNSORTED_INTS[i]);
+        ASSERT_TRUE(tree.checkStructure());
+    }
+
+    EXPECT_EQ(std::vector<int>(TEST_ASCENDING_INTS, TEST_ASCENDING_INTS + TEST_NUM_OF_ELEMENTS), toVector(tree));
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
+        EXPECT_EQ(TEST_UNSORTED_INTS[i], *tree.find(TEST_UNSORTED_INTS[i]));
+    }
+}
+
+TEST(UT018BTree, RandomInsertAndErase_SameSequenceAsStlMultiset) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 300);
+    SmallNodeTree tree;
+    std::multiset<int> stlTree;
+
+    for (int i = 0; i < 3000; ++i) {
+        int value = randDist(randEngine);
+        tree.insert(value);
+        stlTree.insert(value);
+    }
+    ASSERT_TRUE(tree.checkStructure());
+    EXPECT_LT(3u, tree.getHeight());
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+
+    for (int i = 0; i < 2500; ++i) {
+        int value = randDist(randEngine);
+        auto it = tree.find(value);
+        auto stlIt = stlTree.find(value);
+        ASSERT_EQ(stlIt == stlTree.end(), it == tree.end());
+        if (it != tree.end()) {
+            tree.erase(it);
+            stlTree.erase(stlIt);
+        }
+        ASSERT_TRUE(tree.checkStructure());
+    }
+
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+    EXPECT_EQ(stlTree.size(), tree.size());
+}
+
+TEST(UT018BTree, EraseAllItems_EmptyTree) {
+    SmallNodeTree tree;
+    for (int i = 0; i < 1000; ++i) tree.insert(i);
+
+    for (int i = 999; i >= 0; i -= 2) tree.erase(tree.find(i));
+    ASSERT_TRUE(tree.checkStructure());
+    while (!tree.empty()) {
+        tree.erase(tree.begin());
+        ASSERT_TRUE(tree.checkStructure());
+    }
+
+    EXPECT_EQ(0u, tree.getHeight());
+    EXPECT_TRUE(tree.begin() == tree.end());
+}
+
+TEST(UT018BTree, EraseWhileScanning_ReturnsSuccessorLikeStlMultiset) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 300);
+    SmallNodeTree tree;
+    std::multiset<int> stlTree;
+    for (int i = 0; i < 3000; ++i) {
+        int value = randDist(randEngine);
+        tree.insert(value);
+        stlTree.insert(value);
+    }
+
+    // Erasing every odd item shrinks leaves and moves items between them
+    auto stlIt = stlTree.begin();
+    for (auto it = tree.begin(); it != tree.end();) {
+        ASSERT_EQ(*stlIt, *it);
+        if (*it % 2 != 0) {
+            it = tree.erase(it);
+            stlIt = stlTree.erase(stlIt);
+        } else {
+            ++it;
+            ++stlIt;
+        }
+    }
+    ASSERT_TRUE(stlIt == stlTree.end());
+    ASSERT_TRUE(tree.checkStructure());
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+
+    while (!tree.empty()) {
+        auto it = tree.erase(tree.find(*tree.begin()));
+        stlIt = stlTree.erase(stlTree.begin());
+        ASSERT_EQ(stlIt == stlTree.end(), it == tree.end());
+        if (it != tree.end()) {
+            ASSERT_EQ(*stlIt, *it);
+        }
+    }
+    EXPECT_TRUE(tree.erase(tree.end()) == tree.end());
+}
+
+TEST(UT018BTree, EraseByKey_RemovesAllEqualItems) {
+    SmallNodeTree tree;
+    std::multiset<int> stlTree;
+    for (int i = 0; i < 2000; ++i) {
+        tree.insert(i % 100);
+        stlTree.insert(i % 100);
+    }
+
+    // Every value fills more than a leaf, so the erased run spans leaves
+    EXPECT_EQ(20u, tree.erase(42));
+    EXPECT_EQ(0u, tree.erase(42));
+    EXPECT_EQ(0u, tree.erase(1000));
+    stlTree.erase(42);
+    ASSERT_TRUE(tree.checkStructure());
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+
+    for (int i = 0; i < 100; ++i) tree.erase(i);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.checkStructure());
+
+    base::BTree<std::string> strings;
+    strings.insert("a");
+    strings.insert("b");
+    strings.insert("b");
+    EXPECT_EQ(2u, strings.erase(std::string_view("b")));
+    EXPECT_EQ(std::vector<std::string>{"a"}, std::vector<std::string>(strings.begin(), strings.end()));
+}
+
+TEST(UT018BTree, EqualItems_KeepInsertionOrderAndFindReturnsFirst) {
+    typedef std::pair<int, int> Entry;
+    base::BTree<Entry, 64, std::function<bool(const Entry&, const Entry&)>> tree(
+        [](const Entry& lhs, const Entry& rhs) { return lhs.first < rhs.first; });
+    for (int i = 0; i < 100; ++i) tree.insert(Entry(i % 3, i));
+
+    int previousFirst = -1;
+    int previousSecond = -1;
+    for (const Entry& entry : tree) {
+        if (entry.first == previousFirst) {
+            EXPECT_LT(previousSecond, entry.second);
+        }
+        previousFirst = entry.first;
+        previousSecond = entry.second;
+    }
+    EXPECT_EQ(1, tree.find(Entry(1, 0))->second);
+    EXPECT_EQ(2, tree.find(Entry(2, 0))->second);
+}
+
+TEST(UT018BTree, FilledTree_IterateBackwards_DescendingOrder) {
+    SmallNodeTree tree;
+    for (int i = 0; i < 200; ++i) tree.insert(i);
+
+    std::vector<int> items;
+    auto it = tree.find(199);
+    for (std::size_t i = 0; i < tree.size(); ++i, --it) items.push_back(*it);
+
+    std::vector<int> expected;
+    for (int i = 199; i >= 0; --i) expected.push_back(i);
+    EXPECT_EQ(expected, items);
+    EXPECT_TRUE(it == tree.end());
+}
+
+TEST(UT018BTree, StringItems_TransparentFind) {
+    base::BTree<std::string> tree;
+    for (int i = 0; i < 500; ++i) tree.emplace(std::to_string(i));
+
+    EXPECT_TRUE(tree.checkStructure());
+    EXPECT_TRUE(tree.contains(std::string_view("42")));
+    EXPECT_FALSE(tree.contains("500"));
+    EXPECT_EQ("499", *tree.find("499"));
+}
@@ -0,0 +1,322 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+template <uint32_t MaxImbalance, unsigned Features = base::NoFeatures>
+using BalancedTree = base::Tree<int, std::less<>, base::HeapNodeAllocator,
+                                base::TreeOptions<Features, base::HeightBalance<MaxImbalance>>>;
+
+template <class TreeType>
+std::vector<int> toVector(const TreeType& tree) {
+    return std::vector<int>(tree.begin(), tree.end());
+}
+
+template <unsigned Features = base::NoFeatures>
+using WavlTree = base::Tree<int, std::less<>, base::HeapNodeAllocator, base::TreeOptions<Features, base::WavlBalance>>;
+
+// Random inserts and erases, checking the structure after every step
+template <class TreeType>
+void runRandomInsertAndErase(int32_t maxImbalance, unsigned seed) {
+    std::default_random_engine randEngine(seed);
+    std::uniform_int_distribution<int> randDist(0, 500);
+    TreeType tree;
+    std::multiset<int> stlTree;
+
+    for (int i = 0; i < 3000; ++i) {
+        int value = randDist(randEngine);
+        if (i % 3 == 2 && tree.contains(value)) {
+            tree.erase(tree.find(value));
+            stlTree.erase(stlTree.find(value));
+        } else {
+            tree.insert(value);
+            stlTree.insert(value);
+        }
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode(), maxImbalance));
+    }
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+}
+}  // namespace
+
+TEST(UT027BalancePolicy, DefaultOptions_UseAvlBalance) {
+    EXPECT_TRUE((std::is_same_v<base::TreeOptions<>, base::TreeOptions<base::NoFeatures, base::AvlBalance>>));
+}
+
+TEST(UT027BalancePolicy, RelaxedTree_RandomInsertAndErase_ImbalanceWithinTwo) {
+    runRandomInsertAndErase<base::RelaxedTree<int>>(2, 1);
+}
+
+TEST(UT027BalancePolicy, MaxImbalanceThree_RandomInsertAndErase_ImbalanceWithinThree) {
+    runRandomInsertAndErase<BalancedTree<3>>(3, 2);
+}
+
+TEST(UT027BalancePolicy, RelaxedTree_AscendingInsert_FewerRotationsButHigher) {
+    base::InstrumentedTree<int> avlTree;
+    BalancedTree<2, base::Statistics> relaxedTree;
+    for (int i = 0; i < 10000; ++i) {
+        avlTree.insert(i);
+        relaxedTree.insert(i);
+    }
+
+    EXPECT_LT(relaxedTree.getStatistics().rotations, avlTree.getStatistics().rotations);
+    EXPECT_GE(relaxedTree.getHeight(), avlTree.getHeight());
+    EXPECT_LE(relaxedTree.getHeight(), 2 * std::log2(10000.0) + 2);
+    EXPECT_NE(-1, checkAvlSubtree(relaxedTree.getRootNode(), 2));
+}
+
+TEST(UT027BalancePolicy, RelaxedTree_SplitAndJoin_ImbalanceWithinTwo) {
+    std::default_random_engine randEngine(3);
+    std::uniform_int_distribution<int> randDist(0, 5000);
+    base::RelaxedTree<int> tree;
+    for (int i = 0; i < 5000; ++i) tree.insert(randDist(randEngine));
+    std::vector<int> before = toVector(tree);
+
+    for (int i = 0; i < 50; ++i) {
+        base::RelaxedTree<int> greater;
+        tree.split(randDist(randEngine), greater);
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode(), 2));
+        ASSERT_NE(-1, checkAvlSubtree(greater.getRootNode(), 2));
+        tree.join(greater);
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode(), 2));
+    }
+    EXPECT_EQ(before, toVector(tree));
+}
+
+TEST(UT027BalancePolicy, RelaxedTree_SetOperationsAndRangeErase_ImbalanceWithinTwo) {
+    std::default_random_engine randEngine(4);
+    std::uniform_int_distribution<int> randDist(0, 2000);
+    base::RelaxedTree<int> lhs;
+    base::RelaxedTree<int> rhs;
+    std::multiset<int> stlTree;
+    for (int i = 0; i < 3000; ++i) {
+        int value = randDist(randEngine);
+        lhs.insert(value);
+        stlTree.insert(value);
+        rhs.insert(randDist(randEngine) * 2);
+    }
+
+    base::RelaxedTree<int> intersection(rhs);
+    intersection.intersect(lhs);
+    EXPECT_NE(-1, checkAvlSubtree(intersection.getRootNode(), 2));
+
+    stlTree.insert(rhs.begin(), rhs.end());
+    lhs.merge(rhs);
+    EXPECT_NE(-1, checkAvlSubtree(lhs.getRootNode(), 2));
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(lhs));
+
+    lhs.erase(lhs.lower_bound(500), lhs.lower_bound(1500));
+    stlTree.erase(stlTree.lower_bound(500), stlTree.lower_bound(1500));
+    EXPECT_NE(-1, checkAvlSubtree(lhs.getRootNode(), 2));
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(lhs));
+}
+
+TEST(UT027BalancePolicy, RelaxedTreeWithFeatures_RandomInsertAndErase_AugmentationsValid) {
+    std::default_random_engine randEngine(5);
+    std::uniform_int_distribution<int> randDist(0, 500);
+    BalancedTree<2, base::SubtreeSize | base::Threaded> tree;
+    std::multiset<int> stlTree;
+
+    for (int i = 0; i < 3000; ++i) {
+        int value = randDist(randEngine);
+        if (i % 3 == 2 && tree.contains(value)) {
+            tree.erase(tree.find(value));
+            stlTree.erase(stlTree.find(value));
+        } else {
+            tree.insert(value);
+            stlTree.insert(value);
+        }
+    }
+
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode(), 2));
+    EXPECT_EQ(static_cast<int64_t>(stlTree.size()), checkSubtreeSizes(tree.getRootNode()));
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+    EXPECT_EQ(*std::next(stlTree.begin(), 100), *tree.select(100));
+}
+
+TEST(UT027BalancePolicy, WavlTree_InsertOnly_SameAsAvlTree) {
+    base::WavlTree<int> wavlTree;
+    base::Tree<int> avlTree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
+        wavlTree.insert(TEST_UNSORTED_INTS[i]);
+        avlTree.insert(TEST_UNSORTED_INTS[i]);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        wavlTree.insert(i);
+        avlTree.insert(i);
+    }
+
+    EXPECT_NE(-1, checkAvlSubtree(wavlTree.getRootNode()));
+    EXPECT_EQ(avlTree.getHeight(), wavlTree.getHeight());
+    EXPECT_EQ(toVector(avlTree), toVector(wavlTree));
+}
+
+TEST(UT027BalancePolicy, WavlTree_RandomInsertAndErase_RankRuleHolds) {
+    std::default_random_engine randEngine(6);
+    std::uniform_int_distribution<int> randDist(0, 500);
+    base::WavlTree<int> tree;
+    std::multiset<int> stlTree;
+
+    for (int i = 0; i < 6000; ++i) {
+        int value = randDist(randEngine);
+        // Erase heavy phases in between, which leave nodes two ranks above
+        // both children
+        bool eraseHeavy = (i / 1000) % 2 == 1;
+        if ((eraseHeavy || i % 3 == 2) && tree.contains(value)) {
+            tree.erase(tree.find(value));
+            stlTree.erase(stlTree.find(value));
+        } else if (!eraseHeavy || i % 4 == 0) {
+            tree.insert(value);
+            stlTree.insert(value);
+        }
+        ASSERT_NE(-1, checkWavlSubtree(tree.getRootNode()));
+    }
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+
+    while (!tree.empty()) {
+        tree.erase(tree.begin());
+        ASSERT_NE(-1, checkWavlSubtree(tree.getRootNode()));
+    }
+}
+
+TEST(UT027BalancePolicy, WavlTree_Erase_AtMostTwoRotationsAndFewerThanAvl) {
+    std::vector<int> values(20000);
+    for (int i = 0; i < 20000; ++i) values[i] = i;
+    std::shuffle(values.begin(), values.end(), std::default_random_engine(7));
+    WavlTree<base::Statistics> wavlTree;
+    base::InstrumentedTree<int> avlTree;
+    for (int value : values) {
+        wavlTree.insert(value);
+        avlTree.insert(value);
+    }
+    wavlTree.resetStatistics();
+    avlTree.resetStatistics();
+
+    std::shuffle(values.begin(), values.end(), std::default_random_engine(8));
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        uint64_t rotations = wavlTree.getStatistics().rotations;
+        wavlTree.erase(wavlTree.find(values[i]));
+        avlTree.erase(avlTree.find(values[i]));
+        ASSERT_LE(wavlTree.getStatistics().rotations - rotations, 2u);
+        if (i % 1000 == 0) {
+            ASSERT_NE(-1, checkWavlSubtree(wavlTree.getRootNode()));
+        }
+    }
+
+    EXPECT_TRUE(wavlTree.empty());
+    EXPECT_LT(wavlTree.getStatistics().rotations, avlTree.getStatistics().rotations);
+    EXPECT_LT(wavlTree.getStatistics().rebalanceSteps, avlTree.getStatistics().rebalanceSteps);
+}
+
+TEST(UT027BalancePolicy, WavlTree_JoinBasedOperationsAndCopy_RankRuleHolds) {
+    std::default_random_engine randEngine(9);
+    std::uniform_int_distribution<int> randDist(0, 4000);
+    base::WavlTree<int> lhs;
+    base::WavlTree<int> rhs;
+    std::multiset<int> stlTree;
+    for (int i = 0; i < 6000; ++i) {
+        int value = randDist(randEngine);
+        lhs.insert(value);
+        stlTree.insert(value);
+        rhs.insert(randDist(randEngine) * 2);
+    }
+    // Erasing every second item leaves plenty of nodes two ranks above both
+    // children behind
+    for (auto it = lhs.begin(); it != lhs.end();) {
+        stlTree.erase(stlTree.find(*it));
+        it = lhs.erase(it);
+        if (it != lhs.end()) ++it;
+    }
+    for (auto it = rhs.begin(); it != rhs.end();) {
+        it = rhs.erase(it);
+        if (it != rhs.end()) ++it;
+    }
+    ASSERT_NE(-1, checkWavlSubtree(lhs.getRootNode()));
+    ASSERT_NE(-1, checkWavlSubtree(rhs.getRootNode()));
+
+    base::WavlTree<int> copy(lhs);
+    EXPECT_NE(-1, checkWavlSubtree(copy.getRootNode()));
+    EXPECT_EQ(lhs.getHeight(), copy.getHeight());
+
+    for (int i = 0; i < 50; ++i) {
+        base::WavlTree<int> greater;
+        copy.split(randDist(randEngine), greater);
+        ASSERT_NE(-1, checkWavlSubtree(copy.getRootNode()));
+        ASSERT_NE(-1, checkWavlSubtree(greater.getRootNode()));
+        copy.join(greater);
+        ASSERT_NE(-1, checkWavlSubtree(copy.getRootNode()));
+    }
+    EXPECT_EQ(toVector(lhs), toVector(copy));
+
+    base::WavlTree<int> intersection(rhs);
+    intersection.intersect(lhs);
+    EXPECT_NE(-1, checkWavlSubtree(intersection.getRootNode()));
+    base::WavlTree<int> difference(lhs);
+    difference.subtract(rhs);
+    EXPECT_NE(-1, checkWavlSubtree(difference.getRootNode()));
+
+    stlTree.insert(rhs.begin(), rhs.end());
+    lhs.merge(rhs);
+    EXPECT_NE(-1, checkWavlSubtree(lhs.getRootNode()));
+    lhs.erase(lhs.lower_bound(1000), lhs.lower_bound(3000));
+    stlTree.erase(stlTree.lower_bound(1000), stlTree.lower_bound(3000));
+    EXPECT_NE(-1, checkWavlSubtree(lhs.getRootNode()));
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(lhs));
+}
+
+TEST(UT027BalancePolicy, WavlTreeWithFeatures_RandomInsertAndErase_AugmentationsValid) {
+    std::default_random_engine randEngine(10);
+    std::uniform_int_distribution<int> randDist(0, 500);
+    WavlTree<base::SubtreeSize | base::Threaded> tree;
+    std::multiset<int> stlTree;
+
+    for (int i = 0; i < 3000; ++i) {
+        int value = randDist(randEngine);
+        if (i % 2 == 1 && tree.contains(value)) {
+            tree.erase(tree.find(value));
+            stlTree.erase(stlTree.find(value));
+        } else {
+            tree.insert(value);
+            stlTree.insert(value);
+        }
+    }
+
+    EXPECT_NE(-1, checkWavlSubtree(tree.getRootNode()));
+    EXPECT_EQ(static_cast<int64_t>(stlTree.size()), checkSubtreeSizes(tree.getRootNode()));
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+    EXPECT_EQ(*std::next(stlTree.begin(), 100), *tree.select(100));
+}
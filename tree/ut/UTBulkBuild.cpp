@@ -0,0 +1,155 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <functional>
+#include <list>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+template <class TreeType>
+std::vector<int> toVector(const TreeType& tree) {
+    std::vector<int> result;
+    for (auto it = tree.begin(); it != tree.end(); ++it) result.push_back(*it);
+    return result;
+}
+}  // namespace
+
+TEST(UT009BulkBuild, EmptyRange_EmptyTree) {
+    std::vector<int> values;
+    base::Tree<int> tree(values.begin(), values.end());
+
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_EQ(0u, tree.getHeight());
+}
+
+TEST(UT009BulkBuild, SortedRange_PerfectlyBalancedWithValidStructure) {
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) values.push_back(i);
+
+    base::Tree<int> tree(values.begin(), values.end());
+
+    EXPECT_EQ(1000u, tree.size());
+    EXPECT_EQ(10u, tree.getHeight());
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    EXPECT_EQ(values, toVector(tree));
+}
+
+TEST(UT009BulkBuild, UnsortedRange_IteratesSortedWithValidStructure) {
+    base::Tree<int> tree(TEST_UNSORTED_INTS, TEST_UNSORTED_INTS + TEST_NUM_OF_ELEMENTS);
+
+    EXPECT_EQ(std::vector<int>(TEST_ASCENDING_INTS, TEST_ASCENDING_INTS + TEST_NUM_OF_ELEMENTS), toVector(tree));
+    EXPECT_EQ(4u, tree.getHeight());
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT009BulkBuild, DescendingTreeFromAscendingRange_IteratesDescending) {
+    base::Tree<int, std::greater<>> tree(TEST_ASCENDING_INTS, TEST_ASCENDING_INTS + TEST_NUM_OF_ELEMENTS);
+
+    EXPECT_EQ(std::vector<int>(TEST_DESCENDING_INTS, TEST_DESCENDING_INTS + TEST_NUM_OF_ELEMENTS), toVector(tree));
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT009BulkBuild, LargeRandomRange_SameSequenceAsStlMultiset) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(-1000, 1000);
+    std::vector<int> values;
+    for (int i = 0; i < 200000; ++i) values.push_back(randDist(randEngine));
+
+    base::Tree<int> tree(values.begin(), values.end());
+    std::multiset<int> stlTree(values.begin(), values.end());
+
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT009BulkBuild, UnsortedRangeWithDuplicates_EqualElementsKeepInputOrder) {
+    typedef std::pair<int, int> Entry;
+    std::vector<Entry> values{{3, 0}, {1, 1}, {3, 2}, {2, 3}, {1, 4}, {3, 5}};
+    base::Tree<Entry, std::function<bool(Entry, Entry)>> tree(
+        values.begin(), values.end(), [](Entry lhs, Entry rhs) { return lhs.first < rhs.first; });
+
+    std::vector<Entry> expected{{1, 1}, {1, 4}, {2, 3}, {3, 0}, {3, 2}, {3, 5}};
+    std::vector<Entry> actual;
+    for (auto it = tree.begin(); it != tree.end(); ++it) actual.push_back(*it);
+    EXPECT_EQ(expected, actual);
+}
+
+TEST(UT009BulkBuild, InputIteratorRange_IteratesSorted) {
+    std::istringstream input("5 3 9 1");
+    base::Tree<int> tree(std::istream_iterator<int>(input), std::istream_iterator<int>{});
+
+    EXPECT_EQ((std::vector<int>{1, 3, 5, 9}), toVector(tree));
+}
+
+TEST(UT009BulkBuild, SortedListRange_BuiltWithoutRandomAccess) {
+    std::list<std::string> values{"a", "b", "c", "d", "e"};
+    base::Tree<std::string> tree(values.begin(), values.end());
+
+    EXPECT_EQ(5u, tree.size());
+    EXPECT_EQ(3u, tree.getHeight());
+    EXPECT_EQ("a", *tree.begin());
+    EXPECT_TRUE(tree.contains("e"));
+}
+
+TEST(UT009BulkBuild, AssignToFilledTree_ReplacesContent) {
+    base::Tree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_STD_INTS[i]);
+
+    tree.assign(TEST_NON_STD_INTS, TEST_NON_STD_INTS + TEST_NUM_OF_ELEMENTS);
+
+    EXPECT_EQ(TEST_NUM_OF_ELEMENTS, tree.size());
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
+        EXPECT_FALSE(tree.contains(TEST_STD_INTS[i]));
+        EXPECT_TRUE(tree.contains(TEST_NON_STD_INTS[i]));
+    }
+}
+
+TEST(UT009BulkBuild, BuiltTree_InsertAndEraseKeepInvariants) {
+    std::vector<int> values;
+    for (int i = 0; i < 100; ++i) values.push_back(2 * i);
+    base::Tree<int, std::less<>, base::SlabNodeAllocator> tree(values.begin(), values.end());
+
+    for (int i = 0; i < 100; ++i) {
+        tree.insert(2 * i + 1);
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    }
+    for (int i = 0; i < 100; ++i) {
+        tree.erase(tree.find(2 * i));
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    }
+    EXPECT_EQ(100u, tree.size());
+}
@@ -0,0 +1,148 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/compacttree.h>
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+TEST(UT008CompactTree, NodeSize_AtMostHalfOfPointerBasedNode) {
+    EXPECT_LE(2 * sizeof(base::CompactTree<int>::CompactNode), sizeof(base::Node<int>));
+}
+
+TEST(UT008CompactTree, EmptyTree_BeginEqualsEndAndSizeZero) {
+    base::CompactTree<int> tree;
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(0u, tree.getHeight());
+    EXPECT_EQ(0, tree.getBalance());
+    EXPECT_FALSE(tree.contains(3));
+}
+
+TEST(UT008CompactTree, InsertTenUnsortedItems_IteratesSorted) {
+    base::CompactTree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_UNSORTED_INTS[i]);
+
+    int i = 0;
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        ASSERT_EQ(TEST_ASCENDING_INTS[i++], *it);
+    }
+    EXPECT_EQ(TEST_NUM_OF_ELEMENTS, i);
+    EXPECT_TRUE(tree.verifyStructure());
+}
+
+TEST(UT008CompactTree, DescendingTree_InsertTenUnsortedItems_IteratesDescending) {
+    base::CompactTree<int, std::function<bool(int, int)>> tree([](int i, int j) -> bool { return i > j; });
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_UNSORTED_INTS[i]);
+
+    int i = 0;
+    for (auto it = tree.begin(); it != tree.end(); it++) {
+        ASSERT_EQ(TEST_DESCENDING_INTS[i++], *it);
+    }
+}
+
+TEST(UT008CompactTree, InsertTenAscendingValues_getHeight_Return4) {
+    base::CompactTree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_ASCENDING_INTS[i]);
+
+    EXPECT_EQ(4u, tree.getHeight());
+    EXPECT_LE(std::abs(tree.getBalance()), 1);
+}
+
+TEST(UT008CompactTree, InsertTenValues_containsOnlyInsertedValues) {
+    base::CompactTree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_STD_INTS[i]);
+
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
+        EXPECT_TRUE(tree.contains(TEST_STD_INTS[i]));
+        EXPECT_FALSE(tree.contains(TEST_NON_STD_INTS[i]));
+    }
+}
+
+TEST(UT008CompactTree, IterateBackwards_ReturnsDescendingValues) {
+    base::CompactTree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_UNSORTED_INTS[i]);
+
+    auto it = tree.find(34256);
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
+        ASSERT_EQ(TEST_DESCENDING_INTS[i], *it);
+        --it;
+    }
+    EXPECT_TRUE(it == tree.end());
+}
+
+TEST(UT008CompactTree, RandomInsertAndErase_SameSequenceAsStlMultisetAndValidStructure) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 500);
+    std::multiset<int> stlTree;
+    base::CompactTree<int> tree;
+
+    for (int i = 0; i < 5000; ++i) {
+        int value = randDist(randEngine);
+        if (tree.contains(value) && (i % 2) == 0) {
+            tree.erase(tree.find(value));
+            stlTree.erase(stlTree.find(value));
+        } else {
+            tree.insert(value);
+            stlTree.insert(value);
+        }
+        ASSERT_TRUE(tree.verifyStructure());
+    }
+
+    ASSERT_EQ(stlTree.size(), tree.size());
+    std::vector<int> expected(stlTree.begin(), stlTree.end());
+    std::vector<int> actual;
+    for (auto it = tree.begin(); it != tree.end(); ++it) actual.push_back(*it);
+    EXPECT_EQ(expected, actual);
+}
+
+TEST(UT008CompactTree, EraseAllValues_EmptyAndReusable) {
+    base::CompactTree<std::string> tree;
+    for (int i = 0; i < 100; ++i) tree.insert(std::to_string(i));
+    for (int i = 0; i < 100; ++i) {
+        tree.erase(tree.find(std::to_string((i * 7) % 100)));
+        ASSERT_TRUE(tree.verifyStructure());
+    }
+
+    EXPECT_TRUE(tree.empty());
+    tree.insert("again");
+    EXPECT_TRUE(tree.contains("again"));
+    EXPECT_EQ(1u, tree.size());
+}
+
+TEST(UT008CompactTree, EraseEnd_NoChange) {
+    base::CompactTree<int> tree;
+    tree.insert(1);
+    tree.erase(tree.end());
+    EXPECT_EQ(1u, tree.size());
+}
@@ -0,0 +1,117 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/compacttree.h>
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+struct Employee {
+    int id;
+    std::string name;
+};
+
+// Orders employees by id and allows to look them up by id alone
+struct ById {
+    typedef void is_transparent;
+
+    bool operator()(const Employee& lhs, const Employee& rhs) const { return lhs.id < rhs.id; }
+    bool operator()(const Employee& lhs, int rhs) const { return lhs.id < rhs; }
+    bool operator()(int lhs, const Employee& rhs) const { return lhs < rhs.id; }
+};
+
+// Stateful comparator ordering by the remainder of a configurable divisor
+struct ByRemainder {
+    explicit ByRemainder(int divisor) : divisor(divisor) {}
+
+    bool operator()(int lhs, int rhs) const { return lhs % divisor < rhs % divisor; }
+
+    int divisor;
+};
+}  // namespace
+
+TEST(UT011Comparator, StringTree_FindWithStringView_FindsItem) {
+    base::Tree<std::string> tree;
+    tree.insert("apple");
+    tree.insert("banana");
+    tree.insert("cherry");
+
+    std::string_view key("banana");
+
+    EXPECT_EQ("banana", *tree.find(key));
+    EXPECT_TRUE(tree.contains(key));
+    EXPECT_FALSE(tree.contains(std::string_view("date")));
+    EXPECT_TRUE(tree.contains("cherry"));
+}
+
+TEST(UT011Comparator, TransparentFunctionObject_FindByKeyOnly_FindsItem) {
+    base::Tree<Employee, ById> tree;
+    tree.insert(Employee{3, "Carol"});
+    tree.insert(Employee{1, "Alice"});
+    tree.insert(Employee{2, "Bob"});
+
+    EXPECT_EQ("Bob", tree.find(2)->name);
+    EXPECT_TRUE(tree.contains(1));
+    EXPECT_FALSE(tree.contains(4));
+    EXPECT_EQ(tree.end(), tree.find(0));
+}
+
+TEST(UT011Comparator, StatefulComparator_IsUsedForOrdering) {
+    base::Tree<int, ByRemainder> tree(ByRemainder(10));
+    tree.insert(19);
+    tree.insert(21);
+    tree.insert(35);
+
+    auto it = tree.begin();
+    EXPECT_EQ(21, *it++);
+    EXPECT_EQ(35, *it++);
+    EXPECT_EQ(19, *it++);
+    EXPECT_EQ(tree.end(), it);
+    EXPECT_TRUE(tree.contains(5));
+}
+
+TEST(UT011Comparator, StdFunctionComparator_StillSupported) {
+    base::Tree<int, std::function<bool(int, int)>> tree([](int i, int j) { return i > j; });
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_ASCENDING_INTS[i]);
+
+    int i = 0;
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++i) EXPECT_EQ(TEST_DESCENDING_INTS[i], *it);
+}
+
+TEST(UT011Comparator, CompactTree_FindWithStringView_FindsItem) {
+    base::CompactTree<std::string> tree;
+    tree.insert("apple");
+    tree.insert("banana");
+
+    EXPECT_EQ("apple", *tree.find(std::string_view("apple")));
+    EXPECT_FALSE(tree.contains(std::string_view("cherry")));
+}
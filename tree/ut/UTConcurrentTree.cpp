@@ -0,0 +1,162 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/concurrenttree.h>
+
+namespace {
+template <class Guard>
+std::vector<int> toVector(const Guard& guard) {
+    return std::vector<int>(guard.begin(), guard.end());
+}
+}  // namespace
+
+TEST(UT016ConcurrentTree, EmptyTree_ReadGuard_NoItems) {
+    base::ConcurrentTree<int> tree;
+
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(0u, tree.size());
+    EXPECT_FALSE(tree.contains(1));
+    auto guard = tree.read();
+    EXPECT_TRUE(guard.begin() == guard.end());
+}
+
+TEST(UT016ConcurrentTree, InsertAndErase_EveryStateVisibleToReaders) {
+    base::ConcurrentTree<int> tree;
+    std::vector<int> expected;
+
+    // Writes alternate between both instances, so both are checked
+    for (int i = 0; i < 10; ++i) {
+        tree.insert(i);
+        expected.push_back(i);
+        EXPECT_EQ(expected, toVector(tree.read()));
+    }
+    tree.insert(5);
+    EXPECT_EQ(2u, tree.erase(5));
+    EXPECT_EQ(0u, tree.erase(42));
+    expected.erase(expected.begin() + 5);
+    EXPECT_EQ(expected, toVector(tree.read()));
+    EXPECT_EQ(expected, toVector(tree.read()));
+    EXPECT_EQ(9u, tree.size());
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(UT016ConcurrentTree, Modify_AppliedToBothInstances) {
+    base::ConcurrentTree<int, std::greater<>> tree;
+    std::vector<int> values{3, 1, 2};
+    tree.insert(values.begin(), values.end());
+
+    tree.modify([](base::ConcurrentTree<int, std::greater<>>::tree_type& instance) {
+        instance.erase(instance.begin());
+        instance.emplace(7);
+    });
+
+    EXPECT_EQ((std::vector<int>{7, 2, 1}), toVector(tree.read()));
+    tree.insert(0);
+    EXPECT_EQ((std::vector<int>{7, 2, 1, 0}), toVector(tree.read()));
+}
+
+TEST(UT016ConcurrentTree, InsertSinglePassRange_BothInstancesGetAllItems) {
+    base::ConcurrentTree<int> tree;
+    std::istringstream input("5 3 9 1");
+    tree.insert(std::istream_iterator<int>(input), std::istream_iterator<int>{});
+
+    EXPECT_EQ((std::vector<int>{1, 3, 5, 9}), toVector(tree.read()));
+    // The next write toggles to the other instance
+    tree.insert(4);
+    EXPECT_EQ((std::vector<int>{1, 3, 4, 5, 9}), toVector(tree.read()));
+    tree.erase(4);
+    EXPECT_EQ((std::vector<int>{1, 3, 5, 9}), toVector(tree.read()));
+}
+
+TEST(UT016ConcurrentTree, ReadGuardHeld_WriterWaitsAndGuardKeepsOldState) {
+    base::ConcurrentTree<int> tree;
+    tree.insert(1);
+    std::atomic<bool> written(false);
+
+    std::thread writer;
+    {
+        auto guard = tree.read();
+        writer = std::thread([&]() {
+            tree.insert(2);
+            written = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        EXPECT_FALSE(written);
+        EXPECT_EQ(std::vector<int>{1}, toVector(guard));
+    }
+    writer.join();
+
+    EXPECT_TRUE(written);
+    EXPECT_EQ((std::vector<int>{1, 2}), toVector(tree.read()));
+}
+
+TEST(UT016ConcurrentTree, ReadersDuringWrites_AlwaysSeeConsistentState) {
+    const int NUM_OF_ITEMS = 100;
+    base::ConcurrentTree<int, std::less<>, base::SlabNodeAllocator> tree;
+    std::atomic<bool> done(false);
+    std::atomic<int> inconsistent(0);
+    std::atomic<int> reads(0);
+
+    // The writer inserts 0, 1, 2, ... so every state has to be a gapless
+    // sequence starting at 0
+    auto reader = [&]() {
+        while (!done) {
+            auto guard = tree.read();
+            int expected = 0;
+            for (int item : guard) {
+                if (item != expected++) ++inconsistent;
+            }
+            if (static_cast<std::size_t>(expected) != guard->size()) ++inconsistent;
+            if (expected > 0 && !guard->contains(expected - 1)) ++inconsistent;
+            ++reads;
+        }
+    };
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) readers.emplace_back(reader);
+
+    while (reads < 3) std::this_thread::yield();
+    for (int i = 0; i < NUM_OF_ITEMS; ++i) {
+        tree.insert(i);
+        std::this_thread::yield();
+    }
+    done = true;
+    for (auto& thread : readers) thread.join();
+
+    EXPECT_EQ(0, inconsistent);
+    EXPECT_EQ(static_cast<std::size_t>(NUM_OF_ITEMS), tree.size());
+}
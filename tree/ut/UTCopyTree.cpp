@@ -0,0 +1,345 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+typedef base::Tree<int, std::less<>, base::SlabNodeAllocator> SlabTree;
+
+std::vector<int> randomValues(unsigned seed, std::size_t count, int max) {
+    std::default_random_engine randEngine(seed);
+    std::uniform_int_distribution<int> randDist(0, max);
+    std::vector<int> values;
+    for (std::size_t i = 0; i < count; ++i) values.push_back(randDist(randEngine));
+    return values;
+}
+
+template <class TreeType>
+std::vector<int> toVector(const TreeType& tree) {
+    return std::vector<int>(tree.begin(), tree.end());
+}
+
+// True if both subtrees have the same shape and payloads in the same places
+template <class NodeT>
+bool sameStructure(NodeT* lhs, NodeT* rhs) {
+    if (lhs == nullptr || rhs == nullptr) return lhs == rhs;
+    return lhs != rhs && lhs->getPayload() == rhs->getPayload() && lhs->getHeight() == rhs->getHeight() &&
+           sameStructure(lhs->getLeftChild(), rhs->getLeftChild()) &&
+           sameStructure(lhs->getRightChild(), rhs->getRightChild());
+}
+
+// Payload whose copy constructor throws once copiesLeft reaches zero
+struct FailingCopy {
+    static int alive;
+    static int copiesLeft;
+
+    FailingCopy(int v) : value(v) { ++alive; }
+    FailingCopy(const FailingCopy& other) : value(other.value) {
+        if (copiesLeft-- == 0) throw std::runtime_error("copy failed");
+        ++alive;
+    }
+    ~FailingCopy() { --alive; }
+
+    bool operator<(const FailingCopy& other) const { return value < other.value; }
+
+    int value;
+};
+int FailingCopy::alive = 0;
+int FailingCopy::copiesLeft = -1;
+
+// Large enough to run the upper levels of the recursion as pool tasks
+const std::size_t LARGE_COUNT = 100000;
+}  // namespace
+
+TEST(UT026CopyTree, EmptyTree_Copy_IsEmpty) {
+    base::Tree<int> tree;
+    base::Tree<int> copy(tree);
+
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(0u, copy.size());
+    EXPECT_TRUE(copy.begin() == copy.end());
+}
+
+TEST(UT026CopyTree, FilledTree_Copy_SameStructureOnOwnNodes) {
+    base::Tree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_UNSORTED_INTS[i]);
+
+    base::Tree<int> copy(tree);
+
+    EXPECT_TRUE(sameStructure(tree.getRootNode(), copy.getRootNode()));
+    EXPECT_NE(-1, checkAvlSubtree(copy.getRootNode()));
+    EXPECT_EQ(tree.size(), copy.size());
+    EXPECT_EQ(toVector(tree), toVector(copy));
+}
+
+TEST(UT026CopyTree, Copy_Modified_OriginalUnchanged) {
+    base::Tree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_STD_INTS[i]);
+    std::vector<int> before = toVector(tree);
+
+    base::Tree<int> copy(tree);
+    copy.erase(copy.find(TEST_STD_INTS[0]));
+    copy.insert(-1);
+
+    EXPECT_EQ(before, toVector(tree));
+    EXPECT_TRUE(copy.contains(-1));
+    EXPECT_FALSE(copy.contains(TEST_STD_INTS[0]));
+}
+
+TEST(UT026CopyTree, Copy_DoesNotCallComparison) {
+    int comparisons = 0;
+    auto compare = [&comparisons](int lhs, int rhs) {
+        ++comparisons;
+        return lhs < rhs;
+    };
+    base::Tree<int, std::function<bool(int, int)>> tree(compare);
+    for (int i = 0; i < 1000; ++i) tree.insert(i);
+
+    comparisons = 0;
+    base::Tree<int, std::function<bool(int, int)>> copy(tree);
+    EXPECT_EQ(0, comparisons);
+
+    copy.insert(1000);
+    EXPECT_GT(comparisons, 0);
+    EXPECT_EQ(1001u, copy.size());
+}
+
+TEST(UT026CopyTree, Assignment_ReplacesContent) {
+    base::Tree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_STD_INTS[i]);
+    base::Tree<int> other;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) other.insert(TEST_NON_STD_INTS[i]);
+
+    other = tree;
+
+    EXPECT_EQ(toVector(tree), toVector(other));
+    EXPECT_TRUE(sameStructure(tree.getRootNode(), other.getRootNode()));
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) EXPECT_FALSE(other.contains(TEST_NON_STD_INTS[i]));
+}
+
+TEST(UT026CopyTree, SelfAssignment_KeepsContent) {
+    SlabTree tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_STD_INTS[i]);
+    std::vector<int> before = toVector(tree);
+
+    SlabTree& self = tree;
+    tree = self;
+
+    EXPECT_EQ(before, toVector(tree));
+}
+
+TEST(UT026CopyTree, OrderStatisticTree_Copy_SubtreeSizesValid) {
+    base::OrderStatisticTree<int> tree;
+    for (int value : randomValues(1, 5000, 1000)) tree.insert(value);
+
+    base::OrderStatisticTree<int> copy(tree);
+
+    EXPECT_EQ(5000, checkSubtreeSizes(copy.getRootNode()));
+    EXPECT_EQ(*tree.select(2500), *copy.select(2500));
+    EXPECT_EQ(tree.rank(500), copy.rank(500));
+}
+
+TEST(UT026CopyTree, ThreadedTree_Copy_ThreadsLinkCopiedNodes) {
+    base::ThreadedTree<int> tree;
+    for (int value : randomValues(2, 5000, 1000)) tree.insert(value);
+
+    base::ThreadedTree<int> copy(tree);
+    tree.clear();
+
+    std::vector<int> values = toVector(copy);
+    EXPECT_EQ(5000u, values.size());
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST(UT026CopyTree, LargeTree_ParallelCopy_SameStructure) {
+    std::vector<int> values = randomValues(3, LARGE_COUNT, 1000000);
+    base::Tree<int> tree(values.begin(), values.end());
+    tree.insert(values.begin(), values.begin() + 1000);
+    base::ThreadPool pool(4);
+
+    base::Tree<int> copy(tree, pool);
+
+    EXPECT_TRUE(sameStructure(tree.getRootNode(), copy.getRootNode()));
+    EXPECT_NE(-1, checkAvlSubtree(copy.getRootNode()));
+    EXPECT_EQ(tree.size(), copy.size());
+}
+
+TEST(UT026CopyTree, LargeSlabTree_ParallelAssign_AllNodesOwnedByTarget) {
+    std::vector<int> values = randomValues(4, LARGE_COUNT, 1000000);
+    SlabTree tree(values.begin(), values.end());
+    SlabTree copy;
+    copy.insert(1);
+    base::ThreadPool pool(4);
+
+    copy.assign(tree, pool);
+    tree.clear();
+
+    EXPECT_EQ(LARGE_COUNT, copy.size());
+    EXPECT_NE(-1, checkAvlSubtree(copy.getRootNode()));
+    copy.erase(copy.begin());
+    copy.insert(-1);
+    EXPECT_EQ(-1, *copy.begin());
+    copy.clear();
+    EXPECT_EQ(0u, copy.getAllocator().slabCount());
+}
+
+TEST(UT026CopyTree, ThrowingPayloadCopy_AssignmentLeavesTargetUnchanged) {
+    {
+        base::Tree<FailingCopy> tree;
+        for (int i = 0; i < 100; ++i) tree.insert(FailingCopy(i));
+        base::Tree<FailingCopy> target;
+        target.insert(FailingCopy(-1));
+
+        FailingCopy::copiesLeft = 50;
+        EXPECT_THROW(target = tree, std::runtime_error);
+        FailingCopy::copiesLeft = -1;
+
+        EXPECT_EQ(101, FailingCopy::alive);
+        ASSERT_EQ(1u, target.size());
+        EXPECT_EQ(-1, target.begin()->value);
+    }
+    EXPECT_EQ(0, FailingCopy::alive);
+}
+
+TEST(UT026CopyTree, SlabTree_Copy_KeepsAllocatorConfiguration) {
+    SlabTree tree;
+    tree.getAllocator() = base::SlabNodeAllocator<SlabTree::node_type>(64);
+    for (int i = 0; i < 1000; ++i) tree.insert(i);
+
+    SlabTree copy(tree);
+    base::ThreadPool pool(2);
+    SlabTree parallelCopy(tree, pool);
+
+    EXPECT_EQ(64u, copy.getAllocator().maxNodesPerSlab());
+    EXPECT_EQ(64u, parallelCopy.getAllocator().maxNodesPerSlab());
+    EXPECT_EQ(toVector(tree), toVector(copy));
+}
+
+TEST(UT026CopyTree, SlabTreeWithForwardedPool_CopyFromManyThreads_SameItems) {
+    SlabTree tree;
+    tree.getAllocator() = base::SlabNodeAllocator<SlabTree::node_type>(64);
+    for (int i = 0; i < 1000; ++i) tree.insert(i);
+    SlabTree greater;
+    SlabTree other;
+    // The pool of tree moves to greater and from there to other, so tree
+    // only reaches it through the forward links
+    tree.split(500, greater);
+    other.merge(greater);
+
+    // Copying reads the allocator of the const tree, which must not change it
+    const SlabTree& source = tree;
+    std::vector<std::vector<int>> copies(4);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < copies.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            SlabTree copy(source);
+            copies[i] = toVector(copy);
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    for (const std::vector<int>& copy : copies) EXPECT_EQ(toVector(tree), copy);
+    EXPECT_EQ(other.getAllocator().slabCount(), source.getAllocator().slabCount());
+}
+
+TEST(UT026CopyTree, BackgroundTree_Copy_UsesSameReclaimer) {
+    base::NodeReclaimer reclaimer;
+    {
+        base::Tree<int, std::less<>, base::BackgroundNodeAllocator> tree;
+        tree.getAllocator().setReclaimer(reclaimer);
+        tree.insert(1);
+
+        base::Tree<int, std::less<>, base::BackgroundNodeAllocator> copy(tree);
+        EXPECT_EQ(&reclaimer, &copy.getAllocator().getReclaimer());
+    }
+    reclaimer.drain();
+}
+
+TEST(UT026CopyTree, MoveConstruct_TakesOverNodesAndLeavesSourceEmpty) {
+    static_assert(std::is_nothrow_move_constructible_v<SlabTree>);
+    static_assert(std::is_nothrow_move_assignable_v<base::ThreadedTree<int>>);
+    SlabTree tree(TEST_ASCENDING_INTS, TEST_ASCENDING_INTS + TEST_NUM_OF_ELEMENTS);
+    SlabTree::node_type* root = tree.getRootNode();
+    SlabTree::iterator first = tree.begin();
+
+    SlabTree moved(std::move(tree));
+
+    EXPECT_EQ(root, moved.getRootNode());
+    EXPECT_TRUE(first == moved.begin());
+    EXPECT_EQ(TEST_NUM_OF_ELEMENTS, moved.size());
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(nullptr, tree.getRootNode());
+
+    // The moved from tree stays usable
+    tree.insert(7);
+    EXPECT_EQ(std::vector<int>{7}, toVector(tree));
+    EXPECT_NE(-1, checkAvlSubtree(moved.getRootNode()));
+}
+
+TEST(UT026CopyTree, MoveAssign_ReplacesContentWithoutCopying) {
+    SlabTree tree(TEST_ASCENDING_INTS, TEST_ASCENDING_INTS + TEST_NUM_OF_ELEMENTS);
+    SlabTree::node_type* root = tree.getRootNode();
+    SlabTree target;
+    for (int i = 0; i < 100; ++i) target.insert(-i);
+
+    target = std::move(tree);
+
+    EXPECT_EQ(root, target.getRootNode());
+    EXPECT_EQ(std::vector<int>(TEST_ASCENDING_INTS, TEST_ASCENDING_INTS + TEST_NUM_OF_ELEMENTS), toVector(target));
+    EXPECT_TRUE(tree.empty());
+    tree = std::move(target);
+    EXPECT_EQ(root, tree.getRootNode());
+    EXPECT_TRUE(target.empty());
+}
+
+TEST(UT026CopyTree, VectorOfTrees_Growth_MovesTrees) {
+    std::vector<base::Tree<int>> trees;
+    std::vector<base::Tree<int>::node_type*> roots;
+    for (int i = 0; i < 20; ++i) {
+        base::Tree<int> tree;
+        for (int j = 0; j < 10; ++j) tree.insert(i * 10 + j);
+        roots.push_back(tree.getRootNode());
+        trees.push_back(std::move(tree));
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(roots[i], trees[i].getRootNode());
+        EXPECT_EQ(i * 10, *trees[i].begin());
+    }
+}
@@ -22,6 +22,11 @@
  * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
  * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #define _AE_TREE_DEBUGMODE_
@@ -29,6 +34,49 @@
 
 #include "CommonData.h"
 
+namespace {
+// Payload counting every copy and move after construction
+struct MoveCounted {
+    static int copiesAndMoves;
+
+    explicit MoveCounted(int v) : value(v) {}
+    MoveCounted(const MoveCounted& other) : value(other.value) { ++copiesAndMoves; }
+    MoveCounted(MoveCounted&& other) : value(other.value) { ++copiesAndMoves; }
+    MoveCounted& operator=(const MoveCounted& other) {
+        ++copiesAndMoves;
+        value = other.value;
+        return *this;
+    }
+    MoveCounted& operator=(MoveCounted&& other) {
+        ++copiesAndMoves;
+        value = other.value;
+        return *this;
+    }
+
+    bool operator<(const MoveCounted& other) const { return value < other.value; }
+
+    int value;
+};
+int MoveCounted::copiesAndMoves = 0;
+
+// Erases random items one by one, checking the structure after every step
+template <class TreeType>
+void eraseRandomlyAndCheck(TreeType& tree, std::multiset<int>& stlTree, unsigned seed) {
+    std::default_random_engine randEngine(seed);
+    while (!stlTree.empty()) {
+        std::uniform_int_distribution<std::size_t> randDist(0, stlTree.size() - 1);
+        auto stlIt = std::next(stlTree.begin(), static_cast<std::ptrdiff_t>(randDist(randEngine)));
+        auto it = tree.find(*stlIt);
+        ASSERT_TRUE(it != tree.end());
+        tree.erase(it);
+        stlTree.erase(stlIt);
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+        ASSERT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), std::vector<int>(tree.begin(), tree.end()));
+    }
+    EXPECT_TRUE(tree.empty());
+}
+}  // namespace
+
 TEST(UT005EraseItem, RemoveOnlyExistingItem_NoThrowAndSize0) {
     base::Tree<int> tree;
     tree.insert(32987);
@@ -165,3 +213,114 @@ TEST(UT005EraseItem, RemoveItemWithTwoChildrenFarZ_NoThrowSizeCorrectAndCannotFi
     ASSERT_TRUE(tree.find(60) != tree.end());
     ASSERT_TRUE(tree.find(70) != tree.end());
 }
+
+TEST(UT005EraseItem, RemoveItemWithTwoChildren_IteratorsToOtherItemsStayValid) {
+    base::Tree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_UNSORTED_INTS[i]);
+    base::Tree<int>::iterator root(tree.getRootNode());
+    base::Tree<int>::iterator successor = root;
+    ++successor;
+    const int* successorPayload = &*successor;
+    int successorValue = *successor;
+
+    auto next = tree.erase(root);
+
+    EXPECT_TRUE(next == successor);
+    EXPECT_EQ(successorPayload, &*successor);
+    EXPECT_EQ(successorValue, *successor);
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT005EraseItem, RemoveItems_PayloadsNeverCopiedOrMoved) {
+    base::Tree<MoveCounted> tree;
+    for (int i = 0; i < 1000; ++i) tree.emplace(i);
+    MoveCounted::copiesAndMoves = 0;
+
+    for (int i = 0; i < 1000; i += 3) tree.erase(tree.find(MoveCounted(i)));
+
+    EXPECT_EQ(0, MoveCounted::copiesAndMoves);
+    EXPECT_EQ(666u, tree.size());
+}
+
+TEST(UT005EraseItem, RemoveWhileScanning_ReturnedIteratorContinuesScan) {
+    base::Tree<int> tree;
+    for (int i = 0; i < 1000; ++i) tree.insert(i);
+
+    for (auto it = tree.begin(); it != tree.end();) {
+        if (*it % 2 == 0) {
+            it = tree.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    EXPECT_EQ(500u, tree.size());
+    int expected = 1;
+    for (int value : tree) {
+        EXPECT_EQ(expected, value);
+        expected += 2;
+    }
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT005EraseItem, RemoveLastItem_ReturnsEnd) {
+    base::Tree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_UNSORTED_INTS[i]);
+
+    auto last = tree.find(TEST_DESCENDING_INTS[0]);
+    EXPECT_TRUE(tree.erase(last) == tree.end());
+    EXPECT_TRUE(tree.erase(tree.end()) == tree.end());
+}
+
+TEST(UT005EraseItem, RemoveByKey_AllEqualItemsRemovedAndCounted) {
+    base::Tree<int> tree;
+    for (int i = 0; i < 100; ++i) tree.insert(i % 10);
+
+    EXPECT_EQ(10u, tree.erase(3));
+    EXPECT_EQ(0u, tree.erase(3));
+    EXPECT_EQ(0u, tree.erase(42));
+    EXPECT_EQ(90u, tree.size());
+    EXPECT_FALSE(tree.contains(3));
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT005EraseItem, RemoveRandomItems_SameSequenceAsStlMultisetAndValidStructure) {
+    std::default_random_engine randEngine(7);
+    std::uniform_int_distribution<int> randDist(0, 200);
+    base::Tree<int> tree;
+    std::multiset<int> stlTree;
+    for (int i = 0; i < 500; ++i) {
+        int value = randDist(randEngine);
+        tree.insert(value);
+        stlTree.insert(value);
+    }
+
+    eraseRandomlyAndCheck(tree, stlTree, 8);
+}
+
+TEST(UT005EraseItem, OrderStatisticTree_RemoveRandomItems_SubtreeSizesStayValid) {
+    std::default_random_engine randEngine(9);
+    std::uniform_int_distribution<int> randDist(0, 200);
+    base::OrderStatisticTree<int> tree;
+    for (int i = 0; i < 2000; ++i) tree.insert(randDist(randEngine));
+
+    for (std::size_t remaining = tree.size(); remaining > 0; --remaining) {
+        std::uniform_int_distribution<std::size_t> indexDist(0, remaining - 1);
+        tree.erase(tree.select(indexDist(randEngine)));
+        ASSERT_EQ(static_cast<int64_t>(remaining - 1), checkSubtreeSizes(tree.getRootNode()));
+    }
+}
+
+TEST(UT005EraseItem, ThreadedTree_RemoveRandomItems_SameSequenceAsStlMultiset) {
+    std::default_random_engine randEngine(10);
+    std::uniform_int_distribution<int> randDist(0, 200);
+    base::ThreadedTree<int> tree;
+    std::multiset<int> stlTree;
+    for (int i = 0; i < 500; ++i) {
+        int value = randDist(randEngine);
+        tree.insert(value);
+        stlTree.insert(value);
+    }
+
+    eraseRandomlyAndCheck(tree, stlTree, 11);
+}
@@ -0,0 +1,88 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <iterator>
+#include <list>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+TEST(UT020FindBatch, EmptyKeys_WritesNothing) {
+    base::Tree<int> tree;
+    tree.insert(1);
+    std::vector<int> keys;
+    std::vector<base::Tree<int>::iterator> results;
+
+    tree.find_batch(keys.begin(), keys.end(), std::back_inserter(results));
+
+    EXPECT_TRUE(results.empty());
+}
+
+TEST(UT020FindBatch, EmptyTree_AllKeysEnd) {
+    base::Tree<int> tree;
+    std::vector<int> keys{1, 2, 3};
+    std::vector<base::Tree<int>::iterator> results(keys.size());
+
+    auto out = tree.find_batch(keys.begin(), keys.end(), results.begin());
+
+    EXPECT_TRUE(out == results.end());
+    for (auto it = results.begin(); it != results.end(); ++it) EXPECT_EQ(tree.end(), *it);
+}
+
+TEST(UT020FindBatch, RandomKeysMoreThanOneGroup_SameResultsAsFind) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(-5000, 5000);
+    base::Tree<int> tree;
+    for (int i = 0; i < 5000; ++i) tree.insert(randDist(randEngine));
+    std::vector<int> keys;
+    for (int i = 0; i < 1003; ++i) keys.push_back(randDist(randEngine));
+
+    std::vector<base::Tree<int>::iterator> results;
+    tree.find_batch(keys.begin(), keys.end(), std::back_inserter(results));
+
+    ASSERT_EQ(keys.size(), results.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) EXPECT_EQ(tree.find(keys[i]), results[i]);
+}
+
+TEST(UT020FindBatch, HeterogeneousKeysFromList_FindsItems) {
+    base::Tree<std::string> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(std::to_string(TEST_STD_INTS[i]));
+    std::list<std::string_view> keys{"nope", std::string_view(*tree.begin()), "zzz"};
+
+    std::vector<base::Tree<std::string>::iterator> results;
+    tree.find_batch(keys.begin(), keys.end(), std::back_inserter(results));
+
+    ASSERT_EQ(3u, results.size());
+    EXPECT_EQ(tree.end(), results[0]);
+    EXPECT_EQ(tree.begin(), results[1]);
+    EXPECT_EQ(tree.end(), results[2]);
+}
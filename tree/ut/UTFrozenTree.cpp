@@ -0,0 +1,153 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/frozentree.h>
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+template <class Iterator>
+std::vector<int> forwards(Iterator first, Iterator last) {
+    std::vector<int> result;
+    for (; first != last; ++first) result.push_back(*first);
+    return result;
+}
+
+// Item without default constructor
+struct Key {
+    explicit Key(int v) : value(v) {}
+    int value;
+    bool operator<(const Key& other) const { return value < other.value; }
+};
+}  // namespace
+
+TEST(UT019FrozenTree, EmptyTree_BeginIsEndAndNothingFound) {
+    base::Tree<int> tree;
+    base::FrozenTree<int> frozen = tree.freeze();
+
+    EXPECT_TRUE(frozen.empty());
+    EXPECT_EQ(0u, frozen.size());
+    EXPECT_TRUE(frozen.begin() == frozen.end());
+    EXPECT_TRUE(frozen.find(1) == frozen.end());
+    EXPECT_TRUE(frozen.lower_bound(1) == frozen.end());
+    EXPECT_THROW(*frozen.end(), std::out_of_range);
+}
+
+TEST(UT019FrozenTree, FreezeTree_SameSequenceAsTree) {
+    base::Tree<int> tree(TEST_UNSORTED_INTS, TEST_UNSORTED_INTS + TEST_NUM_OF_ELEMENTS);
+    base::FrozenTree<int> frozen = tree.freeze();
+
+    EXPECT_EQ(tree.size(), frozen.size());
+    EXPECT_EQ(forwards(tree.begin(), tree.end()), forwards(frozen.begin(), frozen.end()));
+}
+
+TEST(UT019FrozenTree, AllSizesUpTo100_IterateForwardsAndBackwards) {
+    for (int count = 1; count <= 100; ++count) {
+        std::vector<int> values;
+        for (int i = 0; i < count; ++i) values.push_back(i);
+        base::FrozenTree<int> frozen(values.rbegin(), values.rend());
+
+        ASSERT_EQ(values, forwards(frozen.begin(), frozen.end()));
+
+        std::vector<int> backwards;
+        auto it = frozen.begin();
+        for (int i = 1; i < count; ++i) ++it;
+        for (int i = 0; i < count; ++i) backwards.push_back(*it--);
+        EXPECT_TRUE(it == frozen.end());
+        ASSERT_EQ(std::vector<int>(values.rbegin(), values.rend()), backwards);
+    }
+}
+
+TEST(UT019FrozenTree, FindAndLowerBound_SameResultsAsTree) {
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) values.push_back(3 * i);
+    base::Tree<int> tree(values.begin(), values.end());
+    base::FrozenTree<int> frozen = tree.freeze();
+
+    for (int key = -2; key < 3005; ++key) {
+        auto frozenIt = frozen.find(key);
+        if (tree.contains(key)) {
+            ASSERT_TRUE(frozenIt != frozen.end());
+            EXPECT_EQ(key, *frozenIt);
+        } else {
+            ASSERT_TRUE(frozenIt == frozen.end());
+        }
+        EXPECT_EQ(tree.contains(key), frozen.contains(key));
+
+        auto lowerIt = frozen.lower_bound(key);
+        if (key > 2997) {
+            EXPECT_TRUE(lowerIt == frozen.end());
+        } else {
+            EXPECT_EQ((key + 2) / 3 * 3, *lowerIt);
+        }
+    }
+}
+
+TEST(UT019FrozenTree, Duplicates_FindReturnsFirstEqualAndKeepsInputOrder) {
+    typedef std::pair<int, int> Entry;
+    auto byFirst = [](const Entry& lhs, const Entry& rhs) { return lhs.first < rhs.first; };
+    std::vector<Entry> values{{3, 0}, {1, 1}, {3, 2}, {2, 3}, {1, 4}, {3, 5}};
+    base::FrozenTree<Entry, std::function<bool(const Entry&, const Entry&)>> frozen(values.begin(), values.end(),
+                                                                                  byFirst);
+
+    EXPECT_EQ(1, frozen.find(Entry{1, -1})->second);
+    EXPECT_EQ(3, frozen.find(Entry{2, -1})->second);
+    EXPECT_EQ(0, frozen.find(Entry{3, -1})->second);
+
+    std::vector<Entry> expected{{1, 1}, {1, 4}, {2, 3}, {3, 0}, {3, 2}, {3, 5}};
+    std::vector<Entry> actual(frozen.begin(), frozen.end());
+    EXPECT_EQ(expected, actual);
+}
+
+TEST(UT019FrozenTree, NoDefaultConstructor_BuildsAllSizes) {
+    for (int count = 0; count <= 20; ++count) {
+        std::vector<Key> values;
+        for (int i = count - 1; i >= 0; --i) values.emplace_back(i);
+        base::FrozenTree<Key> frozen(values.begin(), values.end());
+
+        ASSERT_EQ(static_cast<std::size_t>(count), frozen.size());
+        int expected = 0;
+        for (const Key& key : frozen) EXPECT_EQ(expected++, key.value);
+        EXPECT_EQ(count, expected);
+    }
+}
+
+TEST(UT019FrozenTree, DescendingStrings_UsesComparator) {
+    std::vector<std::string> values{"b", "d", "a", "c"};
+    base::FrozenTree<std::string, std::greater<>> frozen(values.begin(), values.end());
+
+    EXPECT_EQ("d", *frozen.begin());
+    EXPECT_EQ("b", *frozen.lower_bound(std::string("bb")));
+    EXPECT_TRUE(frozen.contains("a"));
+    EXPECT_FALSE(frozen.contains("e"));
+}
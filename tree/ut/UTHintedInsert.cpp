@@ -0,0 +1,180 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <functional>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+std::size_t comparisons = 0;
+
+struct CountingLess {
+    bool operator()(int lhs, int rhs) const {
+        ++comparisons;
+        return lhs < rhs;
+    }
+};
+
+template <class TreeType>
+std::vector<int> toVector(const TreeType& tree) {
+    std::vector<int> result;
+    for (auto it = tree.begin(); it != tree.end(); ++it) result.push_back(*it);
+    return result;
+}
+}  // namespace
+
+TEST(UT021HintedInsert, EmptyTree_InsertWithEndHint_BecomesRoot) {
+    base::Tree<int> tree;
+
+    auto it = tree.insert(tree.end(), 5);
+
+    EXPECT_EQ(tree.begin(), it);
+    EXPECT_EQ(1u, tree.size());
+    EXPECT_EQ(it, tree.find(tree.end(), 5));
+}
+
+TEST(UT021HintedInsert, AscendingWithEndHint_OneComparisonPerItem) {
+    base::Tree<int, CountingLess> tree;
+    comparisons = 0;
+    for (int i = 0; i < 10000; ++i) tree.insert(tree.end(), i);
+
+    EXPECT_EQ(9999u, comparisons);
+    EXPECT_EQ(10000u, tree.size());
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    EXPECT_EQ(0, *tree.begin());
+}
+
+TEST(UT021HintedInsert, AscendingWithPreviousItemAsHint_AtMostTwoComparisonsPerItem) {
+    base::Tree<int, CountingLess> tree;
+    comparisons = 0;
+    auto hint = tree.end();
+    for (int i = 0; i < 10000; ++i) hint = tree.insert(hint, i);
+
+    EXPECT_GE(2u * 10000, comparisons);
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT021HintedInsert, DescendingWithBeginHint_OneComparisonPerItem) {
+    base::Tree<int, CountingLess> tree;
+    comparisons = 0;
+    for (int i = 10000; i > 0; --i) tree.insert(tree.begin(), i);
+
+    EXPECT_EQ(9999u, comparisons);
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    EXPECT_EQ(1, *tree.begin());
+}
+
+TEST(UT021HintedInsert, NearlySortedWithEndHint_FarFewerComparisonsThanInsert) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> distance(1, 50);
+    std::vector<int> values;
+    for (int i = 0; i < 10000; ++i) values.push_back(i);
+    for (std::size_t i = 100; i < values.size(); i += 100) std::swap(values[i], values[i - distance(randEngine)]);
+
+    base::Tree<int, CountingLess> hinted;
+    comparisons = 0;
+    for (auto it = values.begin(); it != values.end(); ++it) hinted.insert(hinted.end(), *it);
+    std::size_t hintedComparisons = comparisons;
+
+    base::Tree<int, CountingLess> plain;
+    comparisons = 0;
+    for (auto it = values.begin(); it != values.end(); ++it) plain.insert(*it);
+
+    EXPECT_GT(comparisons, 2 * hintedComparisons);
+    EXPECT_EQ(toVector(plain), toVector(hinted));
+    EXPECT_NE(-1, checkAvlSubtree(hinted.getRootNode()));
+}
+
+TEST(UT021HintedInsert, RandomItemsAndHints_SameSequenceAsMultisetWithValidSizes) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(-300, 300);
+    base::OrderStatisticTree<int> tree;
+    std::multiset<int> stlTree;
+
+    for (int i = 0; i < 3000; ++i) {
+        int value = randDist(randEngine);
+        auto hint = tree.select(static_cast<std::size_t>(randDist(randEngine) + 300) % (tree.size() + 1));
+        auto it = tree.insert(hint, value);
+        stlTree.insert(value);
+        ASSERT_EQ(value, *it);
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    }
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+    EXPECT_EQ(3000, checkSubtreeSizes(tree.getRootNode()));
+}
+
+TEST(UT021HintedInsert, EqualItemAtHint_InsertedRightBeforeHint) {
+    typedef std::pair<int, int> Entry;
+    base::Tree<Entry, std::function<bool(const Entry&, const Entry&)>> tree(
+        [](const Entry& lhs, const Entry& rhs) { return lhs.first < rhs.first; });
+    tree.insert(Entry{1, 0});
+    tree.insert(Entry{2, 1});
+    auto hint = tree.insert(Entry{2, 2});
+    tree.insert(Entry{3, 3});
+
+    tree.emplace_hint(hint, 2, 9);
+
+    std::vector<Entry> expected{{1, 0}, {2, 1}, {2, 9}, {2, 2}, {3, 3}};
+    EXPECT_EQ(expected, std::vector<Entry>(tree.begin(), tree.end()));
+}
+
+TEST(UT021HintedInsert, FindWithRandomHints_SameResultsAsFind) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 3000);
+    base::OrderStatisticTree<int> tree;
+    for (int i = 0; i < 1000; ++i) tree.insert(3 * i);
+
+    for (int i = 0; i < 3000; ++i) {
+        int key = randDist(randEngine);
+        auto hint = tree.select(static_cast<std::size_t>(randDist(randEngine)) % (tree.size() + 1));
+        ASSERT_EQ(tree.find(key), tree.find(hint, key));
+    }
+}
+
+TEST(UT021HintedInsert, FindNeighbourOfHint_FewComparisons) {
+    base::Tree<int, CountingLess> tree;
+    for (int i = 0; i < 100000; ++i) tree.insert(tree.end(), i);
+
+    auto hint = tree.find(5000);
+    comparisons = 0;
+    tree.find(5001);
+    std::size_t plainComparisons = comparisons;
+    comparisons = 0;
+    auto it = tree.find(hint, 5001);
+
+    EXPECT_EQ(5001, *it);
+    EXPECT_GT(plainComparisons, 2 * comparisons);
+    comparisons = 0;
+    EXPECT_EQ(99998, *tree.find(tree.end(), 99998));
+    EXPECT_GT(plainComparisons, 2 * comparisons);
+}
@@ -22,6 +22,7 @@
  * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
  * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <functional>
 #include <random>
 #include <vector>
 
@@ -77,7 +78,7 @@ TEST(UT004Iterator, InsertTenUnsortedItems_PreIncrement_CorrectTenSortedIntsRetu
 }
 
 TEST(UT004Iterator, DescendingTree_InsertTenUnsortedItems_PreIncrement_CorrectTenSortedIntsReturned) {
-    base::Tree<int> tree([](int i, int j) -> bool { return i > j; });
+    base::Tree<int, std::function<bool(int, int)>> tree([](int i, int j) -> bool { return i > j; });
     std::vector<int> ascending;
 
     for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
@@ -109,7 +110,7 @@ TEST(UT004Iterator, InsertTenUnsortedItems_PostIncrement_CorrectTenSortedIntsRet
 }
 
 TEST(UT004Iterator, DescendingTree_InsertTenUnsortedItems_PostIncrement_CorrectTenSortedIntsReturned) {
-    base::Tree<int> tree([](int i, int j) -> bool { return i > j; });
+    base::Tree<int, std::function<bool(int, int)>> tree([](int i, int j) -> bool { return i > j; });
     std::vector<int> ascending;
 
     for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
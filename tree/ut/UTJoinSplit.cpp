@@ -0,0 +1,304 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+typedef base::Tree<int, std::less<>, base::SlabNodeAllocator> SlabTree;
+typedef base::OrderStatisticTree<int> OsTree;
+
+std::vector<int> randomValues(unsigned seed, std::size_t count, int max) {
+    std::default_random_engine randEngine(seed);
+    std::uniform_int_distribution<int> randDist(0, max);
+    std::vector<int> values;
+    for (std::size_t i = 0; i < count; ++i) values.push_back(randDist(randEngine));
+    return values;
+}
+
+template <class TreeType>
+void fill(TreeType& tree, const std::vector<int>& values) {
+    for (int value : values) tree.insert(value);
+}
+
+template <class TreeType>
+std::vector<int> toVector(const TreeType& tree) {
+    return std::vector<int>(tree.begin(), tree.end());
+}
+
+std::vector<int> sorted(std::vector<int> values) {
+    std::sort(values.begin(), values.end());
+    return values;
+}
+}  // namespace
+
+TEST(UT014JoinSplit, RandomTree_Split_PartitionsItemsAtKey) {
+    std::vector<int> values = sorted(randomValues(1, 1000, 200));
+    for (int key : {-1, 0, 17, 100, 150, 200, 201}) {
+        base::Tree<int> tree;
+        base::Tree<int> greater;
+        fill(tree, values);
+
+        tree.split(key, greater);
+
+        auto bound = std::lower_bound(values.begin(), values.end(), key);
+        EXPECT_EQ(std::vector<int>(values.begin(), bound), toVector(tree));
+        EXPECT_EQ(std::vector<int>(bound, values.end()), toVector(greater));
+        EXPECT_EQ(static_cast<std::size_t>(bound - values.begin()), tree.size());
+        EXPECT_EQ(static_cast<std::size_t>(values.end() - bound), greater.size());
+        EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+        EXPECT_NE(-1, checkAvlSubtree(greater.getRootNode()));
+    }
+}
+
+TEST(UT014JoinSplit, SplitTree_JoinAgain_RestoresAllItems) {
+    std::vector<int> values = randomValues(2, 1000, 500);
+    base::Tree<int> tree;
+    base::Tree<int> greater;
+    fill(tree, values);
+
+    tree.split(250, greater);
+    tree.join(greater);
+
+    EXPECT_EQ(sorted(values), toVector(tree));
+    EXPECT_EQ(values.size(), tree.size());
+    EXPECT_TRUE(greater.empty());
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT014JoinSplit, SplitTree_SizeFromManyThreads_SeesSameCounts) {
+    std::vector<int> values = randomValues(16, 20000, 10000);
+    base::Tree<int> tree;
+    base::Tree<int> greater;
+    fill(tree, values);
+    tree.split(5000, greater);
+    std::size_t expectedGreater =
+        static_cast<std::size_t>(std::count_if(values.begin(), values.end(), [](int v) { return v >= 5000; }));
+
+    // size() is const and must not write to the trees, which a race detector
+    // would report here
+    const base::Tree<int>& lessView = tree;
+    const base::Tree<int>& greaterView = greater;
+    std::vector<std::size_t> lessSizes(4);
+    std::vector<std::size_t> greaterSizes(4);
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < 4; ++i) {
+        readers.emplace_back([&, i]() {
+            lessSizes[i] = lessView.size();
+            greaterSizes[i] = greaterView.size();
+        });
+    }
+    for (std::thread& reader : readers) reader.join();
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(values.size() - expectedGreater, lessSizes[i]);
+        EXPECT_EQ(expectedGreater, greaterSizes[i]);
+    }
+}
+
+TEST(UT014JoinSplit, TreesOfVeryDifferentHeight_Join_StaysBalanced) {
+    for (int smallCount : {0, 1, 2, 5}) {
+        base::Tree<int> small;
+        base::Tree<int> large;
+        base::Tree<int> smallAfter;
+        base::Tree<int> largeBefore;
+        for (int i = 0; i < smallCount; ++i) small.insert(i - 10);
+        for (int i = 0; i < 5000; ++i) large.insert(i);
+        for (int i = 0; i < smallCount; ++i) smallAfter.insert(i + 10000);
+        for (int i = 0; i < 5000; ++i) largeBefore.insert(i - 6000);
+
+        small.join(large);
+        largeBefore.join(smallAfter);
+
+        EXPECT_EQ(5000u + smallCount, small.size());
+        EXPECT_EQ(5000u + smallCount, largeBefore.size());
+        EXPECT_NE(-1, checkAvlSubtree(small.getRootNode()));
+        EXPECT_NE(-1, checkAvlSubtree(largeBefore.getRootNode()));
+        EXPECT_TRUE(std::is_sorted(small.begin(), small.end()));
+        EXPECT_TRUE(std::is_sorted(largeBefore.begin(), largeBefore.end()));
+    }
+}
+
+TEST(UT014JoinSplit, OverlappingTrees_Join_Throws) {
+    base::Tree<int> tree;
+    base::Tree<int> other;
+    tree.insert(5);
+    other.insert(4);
+
+    EXPECT_THROW(tree.join(other), std::invalid_argument);
+    EXPECT_EQ(1u, other.size());
+
+    other.clear();
+    other.insert(5);
+    EXPECT_NO_THROW(tree.join(other));
+    EXPECT_EQ(2u, tree.size());
+}
+
+TEST(UT014JoinSplit, RandomTrees_Merge_KeepsAllItemsOfBoth) {
+    std::vector<int> values = randomValues(3, 3000, 1000);
+    std::vector<int> otherValues = randomValues(4, 300, 1000);
+    base::Tree<int> tree;
+    base::Tree<int> other;
+    fill(tree, values);
+    fill(other, otherValues);
+
+    tree.merge(other);
+
+    values.insert(values.end(), otherValues.begin(), otherValues.end());
+    EXPECT_EQ(sorted(values), toVector(tree));
+    EXPECT_EQ(values.size(), tree.size());
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(0u, other.size());
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT014JoinSplit, SmallTreeMergesLargeTree_KeepsAllItemsOfBoth) {
+    std::vector<int> values = randomValues(5, 10, 1000);
+    std::vector<int> otherValues = randomValues(6, 5000, 1000);
+    base::Tree<int> tree;
+    base::Tree<int> other;
+    fill(tree, values);
+    fill(other, otherValues);
+
+    tree.merge(other);
+
+    values.insert(values.end(), otherValues.begin(), otherValues.end());
+    EXPECT_EQ(sorted(values), toVector(tree));
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT014JoinSplit, RandomTrees_IntersectAndSubtract_FilterByOtherTree) {
+    std::vector<int> values = randomValues(7, 2000, 500);
+    std::vector<int> otherValues = randomValues(8, 400, 500);
+    base::Tree<int> intersection;
+    base::Tree<int> difference;
+    base::Tree<int> other;
+    fill(intersection, values);
+    fill(difference, values);
+    fill(other, otherValues);
+
+    intersection.intersect(other);
+    difference.subtract(other);
+
+    std::vector<int> expectedIntersection;
+    std::vector<int> expectedDifference;
+    for (int value : sorted(values)) {
+        if (other.contains(value)) {
+            expectedIntersection.push_back(value);
+        } else {
+            expectedDifference.push_back(value);
+        }
+    }
+    EXPECT_EQ(expectedIntersection, toVector(intersection));
+    EXPECT_EQ(expectedDifference, toVector(difference));
+    EXPECT_EQ(expectedIntersection.size(), intersection.size());
+    EXPECT_EQ(expectedDifference.size(), difference.size());
+    EXPECT_EQ(otherValues.size(), other.size());
+    EXPECT_NE(-1, checkAvlSubtree(intersection.getRootNode()));
+    EXPECT_NE(-1, checkAvlSubtree(difference.getRootNode()));
+}
+
+TEST(UT014JoinSplit, TreeItself_SetOperations_AreHandled) {
+    base::Tree<int> tree;
+    fill(tree, randomValues(9, 100, 50));
+
+    tree.merge(tree);
+    EXPECT_EQ(100u, tree.size());
+    tree.intersect(tree);
+    EXPECT_EQ(100u, tree.size());
+    tree.subtract(tree);
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(UT014JoinSplit, RandomPositions_EraseRange_RemovesExactlyThatRange) {
+    std::vector<int> values = sorted(randomValues(10, 500, 100));
+    std::default_random_engine randEngine(11);
+    for (int round = 0; round < 50; ++round) {
+        std::uniform_int_distribution<std::size_t> posDist(0, values.size());
+        std::size_t first = posDist(randEngine);
+        std::size_t last = posDist(randEngine);
+        if (first > last) std::swap(first, last);
+        base::Tree<int> tree;
+        fill(tree, values);
+
+        auto result = tree.erase(std::next(tree.begin(), first), std::next(tree.begin(), last));
+
+        std::vector<int> expected(values.begin(), values.begin() + first);
+        expected.insert(expected.end(), values.begin() + last, values.end());
+        ASSERT_EQ(expected, toVector(tree));
+        ASSERT_EQ(expected.size(), tree.size());
+        ASSERT_EQ(std::next(tree.begin(), first), result);
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    }
+}
+
+TEST(UT014JoinSplit, OrderStatisticTree_SplitMergeAndErase_KeepSubtreeSizes) {
+    OsTree tree;
+    OsTree greater;
+    OsTree other;
+    fill(tree, randomValues(12, 1000, 300));
+    fill(other, randomValues(13, 200, 300));
+
+    tree.split(150, greater);
+    EXPECT_EQ(tree.size(), static_cast<std::size_t>(checkSubtreeSizes(tree.getRootNode())));
+    EXPECT_EQ(greater.size(), static_cast<std::size_t>(checkSubtreeSizes(greater.getRootNode())));
+
+    tree.join(greater);
+    tree.merge(other);
+    EXPECT_EQ(1200, checkSubtreeSizes(tree.getRootNode()));
+
+    tree.erase(tree.select(100), tree.select(900));
+    EXPECT_EQ(400, checkSubtreeSizes(tree.getRootNode()));
+    EXPECT_EQ(400u, tree.size());
+}
+
+TEST(UT014JoinSplit, SlabTrees_SplitAndMerge_NodesMoveBetweenAllocators) {
+    SlabTree tree;
+    fill(tree, randomValues(14, 5000, 1000));
+    {
+        SlabTree greater;
+        tree.split(500, greater);
+        SlabTree other;
+        fill(other, randomValues(15, 3000, 1000));
+        greater.merge(other);
+        for (int i = 0; i < 1000; ++i) other.insert(i);
+        tree.merge(other);
+        // greater still holds nodes from the slabs of tree and is destroyed first
+    }
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    for (int i = 0; i < 1000; ++i) tree.insert(i);
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+}
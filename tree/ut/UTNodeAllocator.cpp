@@ -0,0 +1,234 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <random>
+#include <set>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+// Payload that keeps track of how many instances are currently alive
+struct LifetimeCounted {
+    static int alive;
+
+    LifetimeCounted(int v) : value(v) { ++alive; }
+    LifetimeCounted(const LifetimeCounted& other) : value(other.value) { ++alive; }
+    ~LifetimeCounted() { --alive; }
+    LifetimeCounted& operator=(const LifetimeCounted& other) = default;
+
+    bool operator<(const LifetimeCounted& other) const { return value < other.value; }
+
+    int value;
+};
+int LifetimeCounted::alive = 0;
+
+typedef base::Tree<int, std::less<>, base::SlabNodeAllocator> SlabTree;
+
+// Links count nodes into a chain of left children, the worst case for a
+// recursive destroy
+template <class Allocator>
+base::Node<LifetimeCounted>* createLeftChain(Allocator& alloc, int count) {
+    base::Node<LifetimeCounted>* root = nullptr;
+    for (int i = 0; i < count; ++i) {
+        base::Node<LifetimeCounted>* node = alloc.create(nullptr, LifetimeCounted(i));
+        node->setLeftChild(root);
+        root = node;
+    }
+    return root;
+}
+}  // namespace
+
+TEST(UT006NodeAllocator, SlabAllocator_DestroyAndCreate_ReusesFreedNode) {
+    base::SlabNodeAllocator<base::Node<int>> alloc;
+    base::Node<int>* first = alloc.create(nullptr, 1);
+    base::Node<int>* second = alloc.create(nullptr, 2);
+
+    alloc.destroy(first);
+    base::Node<int>* third = alloc.create(nullptr, 3);
+
+    EXPECT_EQ(first, third);
+    EXPECT_NE(second, third);
+    EXPECT_EQ(3, third->getPayload());
+
+    alloc.destroy(second);
+    alloc.destroy(third);
+}
+
+TEST(UT006NodeAllocator, SlabAllocator_ManyNodes_SlabsGrowAndAreReleasedByDestroyAll) {
+    SlabTree tree;
+    for (int i = 0; i < 10000; ++i) tree.insert(i);
+
+    EXPECT_GT(tree.getAllocator().slabCount(), 1u);
+    tree.clear();
+    EXPECT_EQ(0u, tree.getAllocator().slabCount());
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(UT006NodeAllocator, SlabTree_InsertTenUnsortedItems_IteratesSorted) {
+    SlabTree tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_UNSORTED_INTS[i]);
+
+    int i = 0;
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        ASSERT_EQ(TEST_ASCENDING_INTS[i++], *it);
+    }
+    EXPECT_EQ(TEST_NUM_OF_ELEMENTS, i);
+}
+
+TEST(UT006NodeAllocator, SlabTree_RandomInsertAndErase_SameSequenceAsStlMultiset) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(-1000, 1000);
+    std::multiset<int> stlTree;
+    SlabTree myTree;
+
+    for (int i = 0; i < 5000; ++i) {
+        int value = randDist(randEngine);
+        if (i % 3 == 2 && myTree.contains(value)) {
+            myTree.erase(myTree.find(value));
+            stlTree.erase(stlTree.find(value));
+        } else {
+            myTree.insert(value);
+            stlTree.insert(value);
+        }
+    }
+
+    ASSERT_EQ(stlTree.size(), myTree.size());
+    auto myIt = myTree.begin();
+    for (int value : stlTree) {
+        EXPECT_EQ(value, *myIt);
+        ++myIt;
+    }
+    EXPECT_TRUE(myIt == myTree.end());
+}
+
+TEST(UT006NodeAllocator, SlabTree_ClearAndRefill_ContainsOnlyNewItems) {
+    SlabTree tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_STD_INTS[i]);
+    tree.clear();
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_NON_STD_INTS[i]);
+
+    EXPECT_EQ(TEST_NUM_OF_ELEMENTS, tree.size());
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
+        EXPECT_FALSE(tree.contains(TEST_STD_INTS[i]));
+        EXPECT_TRUE(tree.contains(TEST_NON_STD_INTS[i]));
+    }
+}
+
+TEST(UT006NodeAllocator, SlabTree_NonTrivialPayload_AllPayloadsDestroyedOnClearAndDestruction) {
+    {
+        base::Tree<LifetimeCounted, std::less<>, base::SlabNodeAllocator> tree;
+        for (int i = 0; i < 1000; ++i) tree.insert(LifetimeCounted(i));
+        tree.erase(tree.find(LifetimeCounted(500)));
+        EXPECT_EQ(999, LifetimeCounted::alive);
+
+        tree.clear();
+        EXPECT_EQ(0, LifetimeCounted::alive);
+
+        for (int i = 0; i < 100; ++i) tree.insert(LifetimeCounted(i));
+        EXPECT_EQ(100, LifetimeCounted::alive);
+    }
+    EXPECT_EQ(0, LifetimeCounted::alive);
+}
+
+TEST(UT006NodeAllocator, SlabTree_StringPayload_FindInsertedValues) {
+    base::Tree<std::string, std::less<>, base::SlabNodeAllocator> tree;
+    tree.insert("delta");
+    tree.insert("alpha");
+    tree.insert("charlie");
+    tree.insert("bravo");
+    tree.erase(tree.find("charlie"));
+
+    EXPECT_TRUE(tree.contains("alpha"));
+    EXPECT_TRUE(tree.contains("bravo"));
+    EXPECT_FALSE(tree.contains("charlie"));
+    EXPECT_TRUE(tree.contains("delta"));
+    EXPECT_EQ("alpha", *tree.begin());
+}
+
+TEST(UT006NodeAllocator, HeapAllocator_DestroyAllOnMillionNodeChain_DoesNotOverflowStack) {
+    base::HeapNodeAllocator<base::Node<LifetimeCounted>> alloc;
+    base::Node<LifetimeCounted>* root = createLeftChain(alloc, 1000000);
+    EXPECT_EQ(1000000, LifetimeCounted::alive);
+
+    alloc.destroyAll(root);
+    EXPECT_EQ(0, LifetimeCounted::alive);
+}
+
+TEST(UT006NodeAllocator, SlabAllocator_SharedPoolDestroyAllOnMillionNodeChain_DoesNotOverflowStack) {
+    base::SlabNodeAllocator<base::Node<LifetimeCounted>> alloc;
+    base::SlabNodeAllocator<base::Node<LifetimeCounted>> other;
+    alloc.adopt(other);
+    base::Node<LifetimeCounted>* root = createLeftChain(alloc, 1000000);
+
+    alloc.destroyAll(root);
+    EXPECT_EQ(0, LifetimeCounted::alive);
+}
+
+TEST(UT006NodeAllocator, BackgroundAllocator_Clear_PayloadsDestroyedByReclaimer) {
+    base::NodeReclaimer reclaimer;
+    base::Tree<LifetimeCounted, std::less<>, base::BackgroundNodeAllocator> tree;
+    tree.getAllocator().setReclaimer(reclaimer);
+    for (int i = 0; i < 10000; ++i) tree.insert(LifetimeCounted(i));
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.begin() == tree.end());
+    reclaimer.drain();
+    EXPECT_EQ(0, LifetimeCounted::alive);
+
+    tree.insert(LifetimeCounted(1));
+    tree.insert(LifetimeCounted(2));
+    tree.erase(tree.find(LifetimeCounted(1)));
+    EXPECT_EQ(1, LifetimeCounted::alive);
+    EXPECT_EQ(2, tree.begin()->value);
+}
+
+TEST(UT006NodeAllocator, BackgroundAllocator_Destruction_PayloadsDestroyedByGlobalReclaimer) {
+    {
+        base::Tree<LifetimeCounted, std::less<>, base::BackgroundNodeAllocator> tree;
+        for (int i = 0; i < 10000; ++i) tree.insert(LifetimeCounted(i % 100));
+        EXPECT_EQ(&base::NodeReclaimer::global(), &tree.getAllocator().getReclaimer());
+    }
+    base::NodeReclaimer::global().drain();
+    EXPECT_EQ(0, LifetimeCounted::alive);
+}
+
+TEST(UT006NodeAllocator, BackgroundAllocator_JoinWithOtherTree_AllNodesReclaimed) {
+    base::Tree<int, std::less<>, base::BackgroundNodeAllocator> left;
+    base::Tree<int, std::less<>, base::BackgroundNodeAllocator> right;
+    for (int i = 0; i < 1000; ++i) left.insert(i);
+    for (int i = 1000; i < 2000; ++i) right.insert(i);
+
+    left.join(right);
+    EXPECT_EQ(2000u, left.size());
+    EXPECT_TRUE(right.empty());
+    left.clear();
+    base::NodeReclaimer::global().drain();
+}
@@ -0,0 +1,129 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+typedef base::OrderStatisticTree<int> OsTree;
+}  // namespace
+
+TEST(UT012OrderStatistic, SizeFeature_DisabledByDefault_NodeStaysSmall) {
+    EXPECT_LT(sizeof(base::Node<int>), sizeof(OsTree::node_type));
+}
+
+TEST(UT012OrderStatistic, SubtreeSize_AsWideAsSizeT_NoWrapBeyond32Bit) {
+    EXPECT_TRUE((std::is_same_v<std::size_t, decltype(OsTree::node_type::getSubtreeSize(nullptr))>));
+}
+
+TEST(UT012OrderStatistic, EmptyTree_SelectAndRank_ReturnEndAndZero) {
+    OsTree tree;
+
+    EXPECT_EQ(tree.end(), tree.select(0));
+    EXPECT_EQ(0u, tree.rank(5));
+    EXPECT_EQ(0u, tree.count_range(0, 10));
+}
+
+TEST(UT012OrderStatistic, TenItems_Select_ReturnsItemsInOrder) {
+    OsTree tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_STD_INTS[i]);
+    std::vector<int> sorted(TEST_STD_INTS, TEST_STD_INTS + TEST_NUM_OF_ELEMENTS);
+    std::sort(sorted.begin(), sorted.end());
+
+    for (std::size_t k = 0; k < sorted.size(); ++k) {
+        EXPECT_EQ(sorted[k], *tree.select(k));
+        EXPECT_EQ(k, tree.rank(sorted[k]));
+    }
+    EXPECT_EQ(tree.end(), tree.select(sorted.size()));
+}
+
+TEST(UT012OrderStatistic, Duplicates_RankAndCountRange_MatchSortedVector) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(-100, 100);
+    OsTree tree;
+    std::vector<int> sorted;
+    for (int i = 0; i < 2000; ++i) {
+        int value = randDist(randEngine);
+        tree.insert(value);
+        sorted.push_back(value);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    for (int value = -110; value <= 110; ++value) {
+        std::size_t expectedRank = std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin();
+        ASSERT_EQ(expectedRank, tree.rank(value));
+    }
+    EXPECT_EQ(static_cast<std::size_t>(std::count(sorted.begin(), sorted.end(), 7)), tree.count_range(7, 8));
+    EXPECT_EQ(sorted.size(), tree.count_range(-1000, 1000));
+    EXPECT_EQ(0u, tree.count_range(50, -50));
+}
+
+TEST(UT012OrderStatistic, RandomInsertAndErase_SubtreeSizesStayConsistent) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 500);
+    OsTree tree;
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert(randDist(randEngine));
+        ASSERT_EQ(static_cast<int64_t>(tree.size()), checkSubtreeSizes(tree.getRootNode()));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        tree.erase(tree.find(randDist(randEngine)));
+        ASSERT_EQ(static_cast<int64_t>(tree.size()), checkSubtreeSizes(tree.getRootNode()));
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    }
+
+    std::size_t k = 0;
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++k) EXPECT_EQ(it, tree.select(k));
+}
+
+TEST(UT012OrderStatistic, BulkBuild_SubtreeSizesAreSet) {
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) values.push_back((i * 7919) % 1000);
+    OsTree tree(values.begin(), values.end());
+
+    EXPECT_EQ(1000, checkSubtreeSizes(tree.getRootNode()));
+    EXPECT_EQ(500, *tree.select(500));
+    EXPECT_EQ(250u, tree.count_range(250, 500));
+}
+
+TEST(UT012OrderStatistic, StringTree_RankWithStringView_Works) {
+    base::OrderStatisticTree<std::string> tree;
+    tree.insert("apple");
+    tree.insert("banana");
+    tree.insert("cherry");
+
+    EXPECT_EQ(1u, tree.rank(std::string_view("b")));
+    EXPECT_EQ(2u, tree.count_range(std::string_view("apple"), std::string_view("c")));
+}
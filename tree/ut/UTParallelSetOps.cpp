@@ -0,0 +1,163 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+typedef base::Tree<int, std::less<>, base::SlabNodeAllocator> SlabTree;
+typedef base::OrderStatisticTree<int> OsTree;
+
+std::vector<int> randomValues(unsigned seed, std::size_t count, int max) {
+    std::default_random_engine randEngine(seed);
+    std::uniform_int_distribution<int> randDist(0, max);
+    std::vector<int> values;
+    for (std::size_t i = 0; i < count; ++i) values.push_back(randDist(randEngine));
+    return values;
+}
+
+template <class TreeType>
+std::vector<int> toVector(const TreeType& tree) {
+    return std::vector<int>(tree.begin(), tree.end());
+}
+
+// Large enough to run the upper levels of the recursion as pool tasks
+const std::size_t LARGE_COUNT = 100000;
+}  // namespace
+
+TEST(UT015ParallelSetOps, LargeTrees_ParallelMerge_SameAsSerialMerge) {
+    std::vector<int> lhs = randomValues(1, LARGE_COUNT, 1000000);
+    std::vector<int> rhs = randomValues(2, LARGE_COUNT / 2, 1000000);
+    for (unsigned threads : {0u, 2u, 4u}) {
+        base::ThreadPool pool(threads);
+        base::Tree<int> serial(lhs.begin(), lhs.end());
+        base::Tree<int> serialOther(rhs.begin(), rhs.end());
+        base::Tree<int> parallel(lhs.begin(), lhs.end());
+        base::Tree<int> parallelOther(rhs.begin(), rhs.end());
+
+        serial.merge(serialOther);
+        parallel.merge(parallelOther, pool);
+
+        EXPECT_EQ(toVector(serial), toVector(parallel));
+        EXPECT_EQ(lhs.size() + rhs.size(), parallel.size());
+        EXPECT_TRUE(parallelOther.empty());
+        EXPECT_NE(-1, checkAvlSubtree(parallel.getRootNode()));
+    }
+}
+
+TEST(UT015ParallelSetOps, LargeTrees_ParallelIntersect_SameAsSerialIntersect) {
+    std::vector<int> lhs = randomValues(3, LARGE_COUNT, 200000);
+    std::vector<int> rhs = randomValues(4, LARGE_COUNT, 200000);
+    base::Tree<int> filter(rhs.begin(), rhs.end());
+    for (unsigned threads : {0u, 2u, 4u}) {
+        base::ThreadPool pool(threads);
+        base::Tree<int> serial(lhs.begin(), lhs.end());
+        base::Tree<int> parallel(lhs.begin(), lhs.end());
+
+        serial.intersect(filter);
+        parallel.intersect(filter, pool);
+
+        EXPECT_EQ(toVector(serial), toVector(parallel));
+        EXPECT_EQ(serial.size(), parallel.size());
+        EXPECT_EQ(rhs.size(), filter.size());
+        EXPECT_NE(-1, checkAvlSubtree(parallel.getRootNode()));
+    }
+}
+
+TEST(UT015ParallelSetOps, LargeTrees_ParallelSubtract_SameAsSerialSubtract) {
+    std::vector<int> lhs = randomValues(5, LARGE_COUNT, 200000);
+    std::vector<int> rhs = randomValues(6, LARGE_COUNT, 200000);
+    SlabTree filter(rhs.begin(), rhs.end());
+    for (unsigned threads : {0u, 2u, 4u}) {
+        base::ThreadPool pool(threads);
+        SlabTree serial(lhs.begin(), lhs.end());
+        SlabTree parallel(lhs.begin(), lhs.end());
+
+        serial.subtract(filter);
+        parallel.subtract(filter, pool);
+
+        EXPECT_EQ(toVector(serial), toVector(parallel));
+        EXPECT_EQ(serial.size(), parallel.size());
+        EXPECT_NE(-1, checkAvlSubtree(parallel.getRootNode()));
+    }
+}
+
+TEST(UT015ParallelSetOps, OrderStatisticTrees_ParallelOps_KeepSubtreeSizes) {
+    std::vector<int> lhs = randomValues(7, LARGE_COUNT, 300000);
+    std::vector<int> rhs = randomValues(8, LARGE_COUNT, 300000);
+    base::ThreadPool pool(2);
+    OsTree tree(lhs.begin(), lhs.end());
+    OsTree other(rhs.begin(), rhs.end());
+    OsTree filter(rhs.begin(), rhs.begin() + LARGE_COUNT / 2);
+
+    tree.merge(other, pool);
+    ASSERT_NE(-1, checkSubtreeSizes(tree.getRootNode()));
+    tree.subtract(filter, pool);
+    ASSERT_NE(-1, checkSubtreeSizes(tree.getRootNode()));
+
+    std::multiset<int> expected(lhs.begin(), lhs.end());
+    expected.insert(rhs.begin(), rhs.end());
+    for (auto it = rhs.begin(); it != rhs.begin() + LARGE_COUNT / 2; ++it) expected.erase(*it);
+    EXPECT_EQ(std::vector<int>(expected.begin(), expected.end()), toVector(tree));
+    EXPECT_EQ(expected.size(), tree.size());
+}
+
+TEST(UT015ParallelSetOps, FilledTree_BulkInsert_SameAsSingleInserts) {
+    std::vector<int> initial = randomValues(9, 1000, 5000);
+    std::vector<int> batch = randomValues(10, LARGE_COUNT, 5000);
+    base::Tree<int> single(initial.begin(), initial.end());
+    for (int value : batch) single.insert(value);
+
+    base::Tree<int> serial(initial.begin(), initial.end());
+    serial.insert(batch.begin(), batch.end());
+    base::ThreadPool pool(2);
+    base::Tree<int> parallel(initial.begin(), initial.end());
+    parallel.insert(batch.begin(), batch.end(), pool);
+
+    EXPECT_EQ(toVector(single), toVector(serial));
+    EXPECT_EQ(toVector(single), toVector(parallel));
+    EXPECT_EQ(single.size(), parallel.size());
+    EXPECT_NE(-1, checkAvlSubtree(serial.getRootNode()));
+    EXPECT_NE(-1, checkAvlSubtree(parallel.getRootNode()));
+}
+
+TEST(UT015ParallelSetOps, EmptyTree_BulkInsertEmptyRange_StaysEmpty) {
+    std::vector<int> batch;
+    base::ThreadPool pool(2);
+    base::Tree<int> tree;
+
+    tree.insert(batch.begin(), batch.end(), pool);
+
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(0u, tree.size());
+}
@@ -0,0 +1,164 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/compacttree.h>
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+// Payload that counts how often it was copied
+struct CopyCounted {
+    static int copies;
+
+    CopyCounted(int v) : value(v) {}
+    CopyCounted(const CopyCounted& other) : value(other.value) { ++copies; }
+    CopyCounted(CopyCounted&& other) noexcept : value(other.value) {}
+    CopyCounted& operator=(const CopyCounted& other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    CopyCounted& operator=(CopyCounted&& other) noexcept {
+        value = other.value;
+        return *this;
+    }
+
+    bool operator<(const CopyCounted& other) const { return value < other.value; }
+
+    int value;
+};
+int CopyCounted::copies = 0;
+
+struct PointeeLess {
+    bool operator()(const std::unique_ptr<int>& lhs, const std::unique_ptr<int>& rhs) const { return *lhs < *rhs; }
+};
+}  // namespace
+
+TEST(UT010PayloadAccess, Tree_InsertFindAndIterate_NoPayloadIsCopied) {
+    base::Tree<CopyCounted> tree;
+    CopyCounted::copies = 0;
+
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(CopyCounted(TEST_STD_INTS[i]));
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) EXPECT_TRUE(tree.contains(CopyCounted(TEST_STD_INTS[i])));
+    int previous = std::numeric_limits<int>::min();
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        EXPECT_LE(previous, it->value);
+        previous = it->value;
+    }
+
+    EXPECT_EQ(0, CopyCounted::copies);
+}
+
+TEST(UT010PayloadAccess, Tree_InsertLvalue_CopiesExactlyOnce) {
+    base::Tree<CopyCounted> tree;
+    CopyCounted item(42);
+    CopyCounted::copies = 0;
+
+    tree.insert(item);
+
+    EXPECT_EQ(1, CopyCounted::copies);
+}
+
+TEST(UT010PayloadAccess, Tree_Emplace_ConstructsInPlace) {
+    base::Tree<CopyCounted> tree;
+    CopyCounted::copies = 0;
+
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.emplace(TEST_STD_INTS[i]);
+
+    EXPECT_EQ(0, CopyCounted::copies);
+    EXPECT_EQ(TEST_NUM_OF_ELEMENTS, tree.size());
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT010PayloadAccess, Tree_MoveOnlyPayload_CanBeInsertedAndFound) {
+    base::Tree<std::unique_ptr<int>, PointeeLess> tree;
+    std::unique_ptr<int> item(new int(5));
+    int* raw = item.get();
+
+    tree.insert(std::move(item));
+    tree.emplace(new int(7));
+
+    EXPECT_FALSE(item);
+    EXPECT_EQ(2u, tree.size());
+    EXPECT_EQ(raw, tree.begin()->get());
+    EXPECT_EQ(5, **tree.begin());
+}
+
+TEST(UT010PayloadAccess, Tree_Insert_ReturnsIteratorToNewItem) {
+    base::Tree<std::string> tree;
+    tree.insert("b");
+    tree.insert("a");
+
+    base::Tree<std::string>::iterator it = tree.insert("b");
+
+    EXPECT_EQ("b", *it);
+    // Equal items are placed behind existing ones
+    EXPECT_EQ(tree.end(), ++it);
+}
+
+TEST(UT010PayloadAccess, Tree_Dereference_ReturnsReferenceToStoredItem) {
+    base::Tree<std::string> tree;
+    tree.insert("item");
+
+    const std::string& first = *tree.find("item");
+    const std::string& second = *tree.begin();
+
+    EXPECT_EQ(&first, &second);
+}
+
+TEST(UT010PayloadAccess, Tree_Iterator_UsableWithStandardAlgorithms) {
+    base::Tree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_STD_INTS[i]);
+
+    std::vector<int> copy(tree.begin(), tree.end());
+
+    EXPECT_EQ(TEST_NUM_OF_ELEMENTS, copy.size());
+    EXPECT_TRUE(std::is_sorted(copy.begin(), copy.end()));
+}
+
+TEST(UT010PayloadAccess, CompactTree_InsertFindAndIterate_NoPayloadIsCopied) {
+    base::CompactTree<CopyCounted> tree;
+    CopyCounted::copies = 0;
+
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.emplace(TEST_STD_INTS[i]);
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) EXPECT_TRUE(tree.contains(CopyCounted(TEST_STD_INTS[i])));
+    int previous = std::numeric_limits<int>::min();
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        EXPECT_LE(previous, it->value);
+        previous = it->value;
+    }
+
+    EXPECT_EQ(0, CopyCounted::copies);
+    EXPECT_EQ(TEST_NUM_OF_ELEMENTS, tree.size());
+}
@@ -0,0 +1,188 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/persistenttree.h>
+
+namespace {
+typedef base::PersistentTree<int> IntTree;
+
+template <class TreeType>
+std::vector<int> toVector(const TreeType& tree) {
+    return std::vector<int>(tree.begin(), tree.end());
+}
+
+// Returns the height of the subtree or -1 if it is no valid AVL tree
+template <class NodeType>
+int checkAvl(const NodeType* node) {
+    if (node == nullptr) return 0;
+    int left = checkAvl(node->getLeftChild());
+    int right = checkAvl(node->getRightChild());
+    if (left < 0 || right < 0 || std::abs(left - right) > 1) return -1;
+    int height = std::max(left, right) + 1;
+    return (static_cast<uint32_t>(height) == node->getHeight()) ? height : -1;
+}
+
+// Payload counting its living instances
+struct Counted {
+    explicit Counted(int v) : value(v) { ++alive; }
+    Counted(const Counted& other) : value(other.value) { ++alive; }
+    ~Counted() { --alive; }
+    bool operator<(const Counted& other) const { return value < other.value; }
+
+    int value;
+    static int alive;
+};
+int Counted::alive = 0;
+}  // namespace
+
+TEST(UT017PersistentTree, EmptyTree_NoItems) {
+    IntTree tree;
+
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(0u, tree.size());
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_TRUE(tree.find(1) == tree.end());
+    EXPECT_EQ(0u, tree.erase(1));
+}
+
+TEST(UT017PersistentTree, RandomInsertAndErase_SameSequenceAsStlMultisetAndBalanced) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 500);
+    IntTree tree;
+    std::multiset<int> stlTree;
+
+    for (int i = 0; i < 2000; ++i) {
+        int value = randDist(randEngine);
+        tree.insert(value);
+        stlTree.insert(value);
+    }
+    ASSERT_NE(-1, checkAvl(tree.getRootNode()));
+    for (int i = 0; i < 300; ++i) {
+        int value = randDist(randEngine);
+        EXPECT_EQ(stlTree.erase(value), tree.erase(value));
+        ASSERT_NE(-1, checkAvl(tree.getRootNode()));
+    }
+
+    EXPECT_EQ(std::vector<int>(stlTree.begin(), stlTree.end()), toVector(tree));
+    EXPECT_EQ(stlTree.size(), tree.size());
+}
+
+TEST(UT017PersistentTree, FilledTree_Find_IteratesFromFirstEqualItem) {
+    IntTree tree;
+    for (int value : {5, 3, 5, 8, 1, 5}) tree.insert(value);
+
+    auto it = tree.find(5);
+    std::vector<int> rest(it, tree.end());
+
+    EXPECT_EQ((std::vector<int>{5, 5, 5, 8}), rest);
+    EXPECT_TRUE(tree.find(4) == tree.end());
+    EXPECT_TRUE(tree.find(9) == tree.end());
+    EXPECT_TRUE(tree.contains(8));
+    EXPECT_FALSE(tree.contains(0));
+}
+
+TEST(UT017PersistentTree, Snapshot_UnchangedByLaterWrites) {
+    IntTree tree;
+    for (int i = 0; i < 100; ++i) tree.insert(i);
+    IntTree snapshot = tree.snapshot();
+
+    for (int i = 0; i < 100; i += 2) tree.erase(i);
+    for (int i = 100; i < 150; ++i) tree.insert(i);
+    IntTree second = tree.snapshot();
+    second.clear();
+
+    std::vector<int> expected;
+    for (int i = 0; i < 100; ++i) expected.push_back(i);
+    EXPECT_EQ(expected, toVector(snapshot));
+    EXPECT_EQ(100u, snapshot.size());
+    EXPECT_EQ(100u, tree.size());
+    EXPECT_TRUE(second.empty());
+    EXPECT_NE(-1, checkAvl(snapshot.getRootNode()));
+    EXPECT_NE(-1, checkAvl(tree.getRootNode()));
+}
+
+TEST(UT017PersistentTree, WritesToSnapshot_DoNotAffectTree) {
+    IntTree tree;
+    for (int i = 0; i < 10; ++i) tree.insert(i);
+    IntTree snapshot = tree.snapshot();
+
+    snapshot.erase(3);
+    snapshot.insert(42);
+
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), toVector(tree));
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 4, 5, 6, 7, 8, 9, 42}), toVector(snapshot));
+}
+
+TEST(UT017PersistentTree, Versions_ShareNodesAndFreeThemWithLastVersion) {
+    {
+        base::PersistentTree<Counted> tree;
+        for (int i = 0; i < 1000; ++i) tree.emplace(i);
+        // Without snapshots all changes are done in place
+        EXPECT_EQ(1000, Counted::alive);
+
+        base::PersistentTree<Counted> snapshot = tree.snapshot();
+        EXPECT_EQ(1000, Counted::alive);
+        tree.emplace(1000);
+        // Only the path to the new leaf has been copied
+        EXPECT_GT(1000 + 1 + 2 * static_cast<int>(tree.getHeight()), Counted::alive);
+
+        snapshot.clear();
+        tree.erase(Counted(500));
+        EXPECT_EQ(1000, Counted::alive);
+    }
+    EXPECT_EQ(0, Counted::alive);
+}
+
+TEST(UT017PersistentTree, SnapshotReadByOtherThread_WhileTreeIsWritten) {
+    IntTree tree;
+    for (int i = 0; i < 10000; ++i) tree.insert(i);
+    std::atomic<long long> sum(0);
+
+    IntTree snapshot = tree.snapshot();
+    std::thread reader([&sum, snapshot]() {
+        long long result = 0;
+        for (int rounds = 0; rounds < 10; ++rounds) {
+            for (int item : snapshot) result += item;
+        }
+        sum = result;
+    });
+    for (int i = 0; i < 10000; i += 3) tree.erase(i);
+    for (int i = 0; i < 5000; ++i) tree.insert(-i);
+    snapshot.clear();
+    reader.join();
+
+    EXPECT_EQ(10 * 49995000LL, sum);
+    EXPECT_EQ(10000u - 3334u + 5000u, tree.size());
+}
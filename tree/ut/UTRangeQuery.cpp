@@ -0,0 +1,141 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+template <class It>
+std::vector<int> toVector(It first, It last) {
+    std::vector<int> result;
+    for (; first != last; ++first) result.push_back(*first);
+    return result;
+}
+}  // namespace
+
+TEST(UT013RangeQuery, EmptyTree_Bounds_ReturnEnd) {
+    base::Tree<int> tree;
+
+    EXPECT_EQ(tree.end(), tree.lower_bound(1));
+    EXPECT_EQ(tree.end(), tree.upper_bound(1));
+    EXPECT_TRUE(tree.range(0, 10).empty());
+}
+
+TEST(UT013RangeQuery, TenItems_LowerAndUpperBound_MatchSortedVector) {
+    base::Tree<int> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(TEST_STD_INTS[i]);
+    std::vector<int> sorted(TEST_STD_INTS, TEST_STD_INTS + TEST_NUM_OF_ELEMENTS);
+    std::sort(sorted.begin(), sorted.end());
+
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) {
+        for (int value : {TEST_STD_INTS[i], TEST_NON_STD_INTS[i]}) {
+            auto lower = std::lower_bound(sorted.begin(), sorted.end(), value);
+            auto upper = std::upper_bound(sorted.begin(), sorted.end(), value);
+            EXPECT_EQ(std::vector<int>(lower, sorted.end()), toVector(tree.lower_bound(value), tree.end()));
+            EXPECT_EQ(std::vector<int>(upper, sorted.end()), toVector(tree.upper_bound(value), tree.end()));
+        }
+    }
+}
+
+TEST(UT013RangeQuery, Duplicates_EqualRange_ContainsAllDuplicatesInInsertionOrder) {
+    typedef std::pair<int, int> Entry;
+    struct ByFirst {
+        bool operator()(const Entry& lhs, const Entry& rhs) const { return lhs.first < rhs.first; }
+    };
+    base::Tree<Entry, ByFirst> tree;
+    for (int i = 0; i < 30; ++i) tree.insert(Entry(i % 3, i));
+
+    auto range = tree.equal_range(Entry(1, 0));
+
+    int expected = 1;
+    for (auto it = range.first; it != range.second; ++it, expected += 3) {
+        EXPECT_EQ(1, it->first);
+        EXPECT_EQ(expected, it->second);
+    }
+    EXPECT_EQ(31, expected);
+}
+
+TEST(UT013RangeQuery, MissingItem_EqualRange_IsEmptyAtInsertPosition) {
+    base::Tree<int> tree;
+    for (int i = 0; i < 10; ++i) tree.insert(2 * i);
+
+    auto range = tree.equal_range(5);
+
+    EXPECT_EQ(range.first, range.second);
+    EXPECT_EQ(6, *range.first);
+}
+
+TEST(UT013RangeQuery, RandomItems_RangeView_IteratesHalfOpenInterval) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(-500, 500);
+    base::Tree<int> tree;
+    std::vector<int> sorted;
+    for (int i = 0; i < 1000; ++i) {
+        int value = randDist(randEngine);
+        tree.insert(value);
+        sorted.push_back(value);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    for (int lo = -510; lo <= 510; lo += 17) {
+        int hi = lo + 40;
+        std::vector<int> expected(std::lower_bound(sorted.begin(), sorted.end(), lo),
+                                  std::lower_bound(sorted.begin(), sorted.end(), hi));
+        std::vector<int> actual;
+        for (int value : tree.range(lo, hi)) actual.push_back(value);
+        ASSERT_EQ(expected, actual);
+    }
+}
+
+TEST(UT013RangeQuery, InvertedOrEmptyInterval_RangeView_IsEmpty) {
+    base::Tree<int> tree;
+    for (int i = 0; i < 10; ++i) tree.insert(i);
+
+    EXPECT_TRUE(tree.range(5, 5).empty());
+    EXPECT_TRUE(tree.range(7, 3).empty());
+    EXPECT_TRUE(tree.range(20, 30).empty());
+    EXPECT_FALSE(tree.range(9, 10).empty());
+}
+
+TEST(UT013RangeQuery, StringTree_PrefixRangeWithStringView_FindsAllWithPrefix) {
+    base::Tree<std::string> tree;
+    for (const char* word : {"car", "cart", "cat", "dog", "ca", "cb", "bca"}) tree.insert(word);
+
+    std::vector<std::string> actual;
+    for (const std::string& word : tree.range(std::string_view("ca"), std::string_view("cb"))) actual.push_back(word);
+
+    EXPECT_EQ(std::vector<std::string>({"ca", "car", "cart", "cat"}), actual);
+    EXPECT_EQ("cb", *tree.lower_bound(std::string_view("cau")));
+    EXPECT_EQ("dog", *tree.upper_bound(std::string_view("cb")));
+}
@@ -0,0 +1,106 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <random>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+TEST(UT007Rebalance, InsertAscendingValues_InvariantsHoldAfterEveryInsert) {
+    base::Tree<int> tree;
+    for (int i = 0; i < 500; ++i) {
+        tree.insert(i);
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    }
+}
+
+TEST(UT007Rebalance, InsertDescendingValues_InvariantsHoldAfterEveryInsert) {
+    base::Tree<int> tree;
+    for (int i = 500; i > 0; --i) {
+        tree.insert(i);
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    }
+}
+
+TEST(UT007Rebalance, InsertManyDuplicates_InvariantsHoldAndAllFound) {
+    base::Tree<int> tree;
+    for (int i = 0; i < 1000; ++i) tree.insert(i % 7);
+
+    ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    EXPECT_EQ(1000, tree.size());
+    for (int i = 0; i < 7; ++i) EXPECT_TRUE(tree.contains(i));
+}
+
+TEST(UT007Rebalance, RandomInsertAndErase_InvariantsHoldAfterEveryOperation) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 300);
+    std::multiset<int> stlTree;
+    base::Tree<int> tree;
+
+    for (int i = 0; i < 3000; ++i) {
+        int value = randDist(randEngine);
+        if (tree.contains(value) && (i % 2) == 0) {
+            tree.erase(tree.find(value));
+            stlTree.erase(stlTree.find(value));
+        } else {
+            tree.insert(value);
+            stlTree.insert(value);
+        }
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    }
+
+    std::vector<int> expected(stlTree.begin(), stlTree.end());
+    std::vector<int> actual;
+    for (auto it = tree.begin(); it != tree.end(); ++it) actual.push_back(*it);
+    EXPECT_EQ(expected, actual);
+}
+
+TEST(UT007Rebalance, EraseAllValuesInInsertionOrder_InvariantsHoldUntilEmpty) {
+    base::Tree<int> tree;
+    for (int i = 0; i < 256; ++i) tree.insert((i * 37) % 256);
+
+    for (int i = 0; i < 256; ++i) {
+        tree.erase(tree.find((i * 37) % 256));
+        ASSERT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+    }
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(0, tree.getHeight());
+}
+
+TEST(UT007Rebalance, OneMillionAscendingValues_HeightIsLogarithmic) {
+    base::Tree<int> tree;
+    for (int i = 0; i < 1000000; ++i) tree.insert(i);
+
+    // An AVL tree of n nodes is never higher than 1.44 * log2(n + 2)
+    EXPECT_LE(tree.getHeight(), 29u);
+    EXPECT_TRUE(tree.contains(0));
+    EXPECT_TRUE(tree.contains(999999));
+    EXPECT_FALSE(tree.contains(1000000));
+}
@@ -0,0 +1,170 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <base/threadpool.h>
+
+#include <random>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+typedef base::ThreadedTree<int> ThreadedTree;
+typedef ThreadedTree::node_type ThreadedNode;
+
+void collectInOrder(ThreadedNode* node, std::vector<ThreadedNode*>& nodes) {
+    if (node == nullptr) return;
+    collectInOrder(node->getLeftChild(), nodes);
+    nodes.push_back(node);
+    collectInOrder(node->getRightChild(), nodes);
+}
+
+// Checks that the thread links follow the in-order sequence of the tree
+// structure and end with nullptr on both sides
+bool threadsMatchStructure(ThreadedTree& tree) {
+    std::vector<ThreadedNode*> nodes;
+    collectInOrder(tree.getRootNode(), nodes);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        ThreadedNode* prev = (i > 0) ? nodes[i - 1] : nullptr;
+        ThreadedNode* next = (i + 1 < nodes.size()) ? nodes[i + 1] : nullptr;
+        if (nodes[i]->getPrev() != prev || nodes[i]->getNext() != next) return false;
+    }
+    return true;
+}
+
+std::vector<int> toVector(const ThreadedTree& tree) {
+    std::vector<int> result;
+    for (auto it = tree.begin(); it != tree.end(); ++it) result.push_back(*it);
+    return result;
+}
+
+std::vector<int> toVector(const std::multiset<int>& tree) { return std::vector<int>(tree.begin(), tree.end()); }
+}  // namespace
+
+TEST(UT022ThreadedTree, RandomInsertsAndErases_ThreadsFollowStructure) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 200);
+    ThreadedTree tree;
+    std::multiset<int> stlTree;
+
+    for (int i = 0; i < 2000; ++i) {
+        int value = randDist(randEngine);
+        if (i % 3 == 2 && tree.contains(value)) {
+            tree.erase(tree.find(value));
+            stlTree.erase(stlTree.find(value));
+        } else if (i % 3 == 1) {
+            tree.insert(tree.lower_bound(value), value);
+            stlTree.insert(value);
+        } else {
+            tree.insert(value);
+            stlTree.insert(value);
+        }
+        ASSERT_TRUE(threadsMatchStructure(tree));
+    }
+    EXPECT_EQ(toVector(stlTree), toVector(tree));
+    EXPECT_NE(-1, checkAvlSubtree(tree.getRootNode()));
+}
+
+TEST(UT022ThreadedTree, IterateBackwards_ReverseSequence) {
+    ThreadedTree tree(TEST_UNSORTED_INTS, TEST_UNSORTED_INTS + TEST_NUM_OF_ELEMENTS);
+
+    std::vector<int> backwards;
+    auto it = tree.begin();
+    for (int i = 1; i < TEST_NUM_OF_ELEMENTS; ++i) ++it;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) backwards.push_back(*it--);
+
+    EXPECT_EQ(std::vector<int>(TEST_DESCENDING_INTS, TEST_DESCENDING_INTS + TEST_NUM_OF_ELEMENTS), backwards);
+    EXPECT_EQ(tree.end(), it);
+    EXPECT_TRUE(threadsMatchStructure(tree));
+}
+
+TEST(UT022ThreadedTree, EraseRangeSplitAndJoin_ThreadsFollowStructure) {
+    std::vector<int> values;
+    for (int i = 0; i < 500; ++i) values.push_back(i);
+    ThreadedTree tree(values.begin(), values.end());
+    ASSERT_TRUE(threadsMatchStructure(tree));
+
+    EXPECT_EQ(300, *tree.erase(tree.find(100), tree.find(300)));
+    EXPECT_TRUE(threadsMatchStructure(tree));
+
+    ThreadedTree greater;
+    tree.split(400, greater);
+    EXPECT_TRUE(threadsMatchStructure(tree));
+    EXPECT_TRUE(threadsMatchStructure(greater));
+    EXPECT_EQ(tree.end(), ++tree.find(399));
+    EXPECT_EQ(greater.end(), --greater.begin());
+
+    tree.join(greater);
+    EXPECT_TRUE(threadsMatchStructure(tree));
+    EXPECT_EQ(300u, tree.size());
+    EXPECT_EQ(99, *(--tree.find(300)));
+}
+
+TEST(UT022ThreadedTree, MergeIntersectSubtract_ThreadsFollowStructure) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 1000);
+    std::vector<int> lhsValues;
+    std::vector<int> rhsValues;
+    for (int i = 0; i < 3000; ++i) lhsValues.push_back(randDist(randEngine));
+    for (int i = 0; i < 500; ++i) rhsValues.push_back(randDist(randEngine));
+    std::multiset<int> stlUnion(lhsValues.begin(), lhsValues.end());
+    stlUnion.insert(rhsValues.begin(), rhsValues.end());
+
+    ThreadedTree merged(lhsValues.begin(), lhsValues.end());
+    ThreadedTree other(rhsValues.begin(), rhsValues.end());
+    merged.merge(other);
+    EXPECT_TRUE(threadsMatchStructure(merged));
+    EXPECT_EQ(toVector(stlUnion), toVector(merged));
+
+    ThreadedTree intersected(lhsValues.begin(), lhsValues.end());
+    ThreadedTree filter(rhsValues.begin(), rhsValues.end());
+    intersected.intersect(filter);
+    EXPECT_TRUE(threadsMatchStructure(intersected));
+
+    ThreadedTree subtracted(lhsValues.begin(), lhsValues.end());
+    subtracted.subtract(filter);
+    EXPECT_TRUE(threadsMatchStructure(subtracted));
+    EXPECT_EQ(lhsValues.size(), intersected.size() + subtracted.size());
+}
+
+TEST(UT022ThreadedTree, ParallelMergeAndBulkInsert_ThreadsFollowStructure) {
+    base::ThreadPool pool(2);
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 100000);
+    std::vector<int> values;
+    for (int i = 0; i < 20000; ++i) values.push_back(randDist(randEngine));
+
+    ThreadedTree tree(values.begin(), values.begin() + 10000);
+    tree.insert(values.begin() + 10000, values.end(), pool);
+
+    EXPECT_TRUE(threadsMatchStructure(tree));
+    std::multiset<int> stlTree(values.begin(), values.end());
+    EXPECT_EQ(toVector(stlTree), toVector(tree));
+}
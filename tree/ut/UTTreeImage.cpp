@@ -0,0 +1,215 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <base/oshelper.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+#include <tree/treeimage.h>
+
+#include "CommonData.h"
+
+namespace {
+template <class TreeType>
+std::vector<typename TreeType::iterator::value_type> toVector(const TreeType& tree) {
+    return std::vector<typename TreeType::iterator::value_type>(tree.begin(), tree.end());
+}
+
+void writeString(std::ostream& out, const std::string& item) {
+    uint32_t length = static_cast<uint32_t>(item.size());
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(item.data(), length);
+}
+
+std::string readString(std::istream& in) {
+    uint32_t length = 0;
+    in.read(reinterpret_cast<char*>(&length), sizeof(length));
+    std::string item(length, '\0');
+    in.read(&item[0], length);
+    return item;
+}
+}  // namespace
+
+TEST(UT024TreeImage, EmptyTree_SaveAndLoad_StaysEmpty) {
+    base::Tree<int> tree;
+    std::stringstream image;
+    tree.save(image);
+
+    base::Tree<int> loaded;
+    loaded.insert(1);
+    loaded.load(image);
+
+    EXPECT_TRUE(loaded.empty());
+    EXPECT_EQ(0u, loaded.size());
+}
+
+TEST(UT024TreeImage, RandomInts_SaveAndLoad_SameSequencePerfectlyBalanced) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(-1000, 1000);
+    base::Tree<int> tree;
+    for (int i = 0; i < 1023; ++i) tree.insert(randDist(randEngine));
+    std::stringstream image;
+    tree.save(image);
+
+    base::OrderStatisticTree<int> loaded;
+    loaded.load(image);
+
+    EXPECT_EQ(toVector(tree), toVector(loaded));
+    EXPECT_EQ(10u, loaded.getHeight());
+    EXPECT_NE(-1, checkAvlSubtree(loaded.getRootNode()));
+    EXPECT_EQ(1023, checkSubtreeSizes(loaded.getRootNode()));
+}
+
+TEST(UT024TreeImage, Strings_SaveAndLoadWithCodec_SameSequence) {
+    base::Tree<std::string> tree;
+    for (int i = 0; i < TEST_NUM_OF_ELEMENTS; ++i) tree.insert(std::string(30, 'x') + std::to_string(TEST_STD_INTS[i]));
+    std::stringstream image;
+    tree.save(image, writeString);
+
+    base::Tree<std::string> loaded;
+    loaded.load(image, readString);
+
+    EXPECT_EQ(toVector(tree), toVector(loaded));
+}
+
+TEST(UT024TreeImage, BrokenImages_LoadThrowsAndKeepsContent) {
+    base::Tree<int> tree(TEST_ASCENDING_INTS, TEST_ASCENDING_INTS + TEST_NUM_OF_ELEMENTS);
+    std::stringstream image;
+    tree.save(image);
+    std::string bytes = image.str();
+
+    base::Tree<int> loaded;
+    loaded.insert(42);
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW(loaded.load(truncated), std::runtime_error);
+    std::stringstream noMagic("x" + bytes.substr(1));
+    EXPECT_THROW(loaded.load(noMagic), std::runtime_error);
+    std::stringstream encoded(bytes);
+    auto readInt = [](std::istream& in) {
+        int item = 0;
+        in.read(reinterpret_cast<char*>(&item), sizeof(item));
+        return item;
+    };
+    EXPECT_THROW(loaded.load(encoded, readInt), std::runtime_error);
+    base::Tree<int64_t> wrongSize;
+    std::stringstream otherSize(bytes);
+    EXPECT_THROW(wrongSize.load(otherSize), std::runtime_error);
+
+    EXPECT_EQ(std::vector<int>{42}, toVector(loaded));
+}
+
+TEST(UT024TreeImage, HugeCountInHeader_LoadThrowsWithoutAllocating) {
+    std::stringstream raw;
+    base::TreeImageHeader::forRawItems<int>(uint64_t(1) << 60).write(raw);
+    raw.write("\1\0\0\0\2\0\0\0", 8);
+    std::stringstream encoded;
+    base::TreeImageHeader::forEncodedItems(uint64_t(1) << 60).write(encoded);
+    writeString(encoded, "a");
+
+    base::Tree<int> loaded;
+    loaded.insert(42);
+    EXPECT_THROW(loaded.load(raw), std::runtime_error);
+    EXPECT_EQ(std::vector<int>{42}, toVector(loaded));
+
+    base::Tree<std::string> strings;
+    EXPECT_THROW(strings.load(encoded, readString), std::runtime_error);
+    EXPECT_TRUE(strings.empty());
+}
+
+TEST(UT024TreeImage, MappedFile_LookupsInPlaceAndLoadIntoTree) {
+    std::vector<int> values;
+    for (int i = 0; i < 10000; ++i) values.push_back(2 * i);
+    base::ThreadedTree<int> tree(values.begin(), values.end());
+    std::filesystem::path dir = base::createTempDir("ut_tree_image");
+    std::filesystem::path file = dir / "tree.img";
+    {
+        std::ofstream out(file, std::ios::binary);
+        tree.save(out);
+    }
+
+    {
+        base::TreeImage<int> image(file);
+        EXPECT_EQ(10000u, image.size());
+        EXPECT_EQ(values, std::vector<int>(image.begin(), image.end()));
+        EXPECT_EQ(1000, *image.find(1000));
+        EXPECT_TRUE(image.find(1001) == image.end());
+        EXPECT_EQ(1002, *image.lower_bound(1001));
+        EXPECT_EQ(1002, *image.upper_bound(1000));
+        EXPECT_FALSE(image.contains(-2));
+
+        base::ThreadedTree<int> loaded;
+        base::loadTreeImage(loaded, image);
+        EXPECT_EQ(values, toVector(loaded));
+        EXPECT_NE(-1, checkAvlSubtree(loaded.getRootNode()));
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(UT024TreeImage, MappedFileOfOtherType_Throws) {
+    base::Tree<int> tree(TEST_ASCENDING_INTS, TEST_ASCENDING_INTS + TEST_NUM_OF_ELEMENTS);
+    std::filesystem::path dir = base::createTempDir("ut_tree_image");
+    std::filesystem::path file = dir / "tree.img";
+    {
+        std::ofstream out(file, std::ios::binary);
+        tree.save(out);
+    }
+
+    EXPECT_THROW(base::TreeImage<double> image(file), std::runtime_error);
+    EXPECT_THROW(base::TreeImage<int> image(dir / "missing.img"), std::runtime_error);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(UT024TreeImage, MappedFileWithMisalignedItems_Throws) {
+    base::TreeImageHeader header = base::TreeImageHeader::forRawItems<int>(2);
+    header.itemOffset += 1;
+    std::filesystem::path dir = base::createTempDir("ut_tree_image");
+    std::filesystem::path file = dir / "tree.img";
+    {
+        std::ofstream out(file, std::ios::binary);
+        header.write(out);
+        // Enough bytes for both items, so only the alignment is wrong
+        out.write("\1\0\0\0\2\0\0\0\0\0\0", 11);
+    }
+
+    try {
+        base::TreeImage<int> image(file);
+        ADD_FAILURE() << "Misaligned image was mapped";
+    } catch (const std::runtime_error& error) {
+        EXPECT_EQ(std::string("Tree image has misaligned items"), error.what());
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,182 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/treemap.h>
+
+namespace {
+// Counts how often keys get compared, values must never be touched
+int keyComparisons = 0;
+
+struct CountingLess {
+    bool operator()(int lhs, int rhs) const {
+        ++keyComparisons;
+        return lhs < rhs;
+    }
+};
+}  // namespace
+
+TEST(UT023TreeMap, EmptyMap_NothingFound) {
+    base::TreeMap<int, std::string> map;
+
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(0u, map.size());
+    EXPECT_TRUE(map.begin() == map.end());
+    EXPECT_TRUE(map.find(1) == map.end());
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_THROW(map.at(1), std::out_of_range);
+    EXPECT_EQ(0u, map.erase(1));
+}
+
+TEST(UT023TreeMap, SubscriptOperator_InsertsValueInitializedAndUpdatesInPlace) {
+    base::TreeMap<std::string, int> map;
+
+    map["b"] += 2;
+    map["a"] += 1;
+    map["b"] += 3;
+
+    EXPECT_EQ(2u, map.size());
+    EXPECT_EQ(1, map.at("a"));
+    EXPECT_EQ(5, map.at("b"));
+    EXPECT_EQ("a", map.begin()->first);
+}
+
+TEST(UT023TreeMap, TryEmplace_ConstructsOnlyForMissingKey) {
+    base::TreeMap<int, std::unique_ptr<int>> map;
+
+    auto first = map.try_emplace(1, std::make_unique<int>(10));
+    std::unique_ptr<int> second = std::make_unique<int>(20);
+    auto repeated = map.try_emplace(1, std::move(second));
+
+    EXPECT_TRUE(first.second);
+    EXPECT_FALSE(repeated.second);
+    EXPECT_TRUE(first.first == repeated.first);
+    EXPECT_EQ(10, *map.at(1));
+}
+
+TEST(UT023TreeMap, TryEmplaceMovedKey_MovedOnlyIfInserted) {
+    base::TreeMap<std::string, int> map;
+    std::string key(40, 'k');
+
+    map.try_emplace(std::string(key), 1);
+    std::string again = key;
+    auto result = map.try_emplace(std::move(again), 2);
+
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(key, again);
+    EXPECT_EQ(1, map.at(key));
+}
+
+TEST(UT023TreeMap, IteratorWrite_ChangesValueKeepsOrder) {
+    base::TreeMap<int, int> map;
+    for (int i = 0; i < 100; ++i) map.insert(std::make_pair(99 - i, i));
+
+    for (auto it = map.begin(); it != map.end(); ++it) it->second = it->first * 2;
+
+    int expectedKey = 0;
+    for (auto it = map.begin(); it != map.end(); ++it, ++expectedKey) {
+        EXPECT_EQ(expectedKey, it->first);
+        EXPECT_EQ(expectedKey * 2, it->second);
+    }
+}
+
+TEST(UT023TreeMap, InsertOrAssign_OverwritesExistingValue) {
+    base::TreeMap<int, std::string> map;
+
+    EXPECT_TRUE(map.insert_or_assign(1, "one").second);
+    EXPECT_FALSE(map.insert_or_assign(1, "uno").second);
+    EXPECT_FALSE(map.insert(std::make_pair(1, std::string("eins"))).second);
+
+    EXPECT_EQ("uno", map.at(1));
+    EXPECT_EQ(1u, map.size());
+}
+
+TEST(UT023TreeMap, TransparentCompare_FindByStringView) {
+    base::TreeMap<std::string, int> map;
+    map["apple"] = 1;
+    map["pear"] = 2;
+
+    const base::TreeMap<std::string, int>& constMap = map;
+    EXPECT_EQ(2, constMap.find(std::string_view("pear"))->second);
+    EXPECT_TRUE(constMap.contains(std::string_view("apple")));
+    EXPECT_TRUE(constMap.find(std::string_view("plum")) == constMap.end());
+}
+
+TEST(UT023TreeMap, OnlyKeysCompared_SingleDescentPerSubscript) {
+    base::TreeMap<int, int, CountingLess> map;
+    for (int i = 0; i < 1023; ++i) map[i] = i;
+    uint32_t height = map.getHeight();
+
+    keyComparisons = 0;
+    ++map[511];
+    EXPECT_GE(static_cast<int>(2 * height), keyComparisons);
+
+    keyComparisons = 0;
+    ++map[2000];
+    EXPECT_GE(static_cast<int>(2 * height), keyComparisons);
+    EXPECT_EQ(1, map.at(2000));
+}
+
+TEST(UT023TreeMap, RandomOperations_SameContentAsStlMap) {
+    std::default_random_engine randEngine;
+    std::uniform_int_distribution<int> randDist(0, 300);
+    base::TreeMap<int, int> map;
+    std::map<int, int> stlMap;
+
+    for (int i = 0; i < 5000; ++i) {
+        int key = randDist(randEngine);
+        if (i % 4 == 3) {
+            EXPECT_EQ(stlMap.erase(key), map.erase(key));
+        } else if (i % 4 == 2 && map.contains(key)) {
+            auto next = map.erase(map.find(key));
+            auto stlNext = stlMap.erase(stlMap.find(key));
+            ASSERT_EQ(stlNext == stlMap.end(), next == map.end());
+            if (next != map.end()) {
+                EXPECT_EQ(stlNext->first, next->first);
+            }
+        } else {
+            map[key] += i;
+            stlMap[key] += i;
+        }
+    }
+
+    ASSERT_EQ(stlMap.size(), map.size());
+    auto stlIt = stlMap.begin();
+    for (auto it = map.begin(); it != map.end(); ++it, ++stlIt) {
+        EXPECT_EQ(stlIt->first, it->first);
+        EXPECT_EQ(stlIt->second, it->second);
+    }
+    EXPECT_EQ(stlMap.lower_bound(150)->first, map.lower_bound(150)->first);
+    EXPECT_EQ(stlMap.upper_bound(150)->first, map.upper_bound(150)->first);
+}
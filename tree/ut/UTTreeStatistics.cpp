@@ -0,0 +1,153 @@
+/**
+ * @author     Andreas Evers
+ *
+ * @copyright  Copyright © 2020 Andreas Evers
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <base/threadpool.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _AE_TREE_DEBUGMODE_
+#include <tree/tree.h>
+
+#include "CommonData.h"
+
+namespace {
+int comparisons = 0;
+
+struct CountingLess {
+    bool operator()(int lhs, int rhs) const {
+        ++comparisons;
+        return lhs < rhs;
+    }
+};
+}  // namespace
+
+TEST(UT025TreeStatistics, NewTree_AllCountersZero) {
+    base::InstrumentedTree<int> tree;
+    const base::TreeStatistics& stats = tree.getStatistics();
+
+    EXPECT_EQ(0u, stats.inserts);
+    EXPECT_EQ(0u, stats.comparisons);
+    EXPECT_EQ(0u, stats.lookups);
+    EXPECT_TRUE(stats.lookupDepths.empty());
+    EXPECT_EQ(0.0, stats.averageLookupDepth());
+}
+
+TEST(UT025TreeStatistics, AscendingInserts_CountsRotationsAndComparisons) {
+    base::Tree<int, CountingLess, base::HeapNodeAllocator, base::TreeOptions<base::Statistics>> tree;
+    comparisons = 0;
+    for (int i = 0; i < 1023; ++i) tree.insert(i);
+    const base::TreeStatistics& stats = tree.getStatistics();
+
+    EXPECT_EQ(1023u, stats.inserts);
+    EXPECT_EQ(static_cast<uint64_t>(comparisons), stats.comparisons);
+    // Ascending input gives a perfect tree after a rotation at every power of two,
+    // except for the first two items
+    EXPECT_EQ(1023u - 10u, stats.rotations);
+    EXPECT_LE(stats.rotations, stats.rebalanceSteps);
+}
+
+TEST(UT025TreeStatistics, Lookups_DepthHistogramOfPerfectTree) {
+    std::vector<int> values;
+    for (int i = 0; i < 1023; ++i) values.push_back(i);
+    base::InstrumentedTree<int> tree(values.begin(), values.end());
+    tree.resetStatistics();
+
+    for (int i = 0; i < 1023; ++i) tree.contains(i);
+    tree.find(-1);
+    const base::TreeStatistics& stats = tree.getStatistics();
+
+    EXPECT_EQ(1024u, stats.lookups);
+    ASSERT_EQ(11u, stats.lookupDepths.size());
+    EXPECT_EQ(0u, stats.lookupDepths[0]);
+    for (uint32_t depth = 1; depth < 10; ++depth) EXPECT_EQ(1u << (depth - 1), stats.lookupDepths[depth]);
+    EXPECT_EQ(512u + 1u, stats.lookupDepths[10]);
+}
+
+TEST(UT025TreeStatistics, Erases_CountedOncePerItem) {
+    base::InstrumentedTree<int> tree(TEST_ASCENDING_INTS, TEST_ASCENDING_INTS + TEST_NUM_OF_ELEMENTS);
+    tree.resetStatistics();
+
+    // Erasing the root mostly takes the path for nodes with two children
+    while (!tree.empty()) tree.erase(base::InstrumentedTree<int>::iterator(tree.getRootNode()));
+
+    EXPECT_EQ(static_cast<uint64_t>(TEST_NUM_OF_ELEMENTS), tree.getStatistics().erases);
+    EXPECT_LT(0u, tree.getStatistics().rebalanceSteps);
+}
+
+TEST(UT025TreeStatistics, EraseByKeyRangeAndFilter_CountsEveryItem) {
+    std::vector<int> values;
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(i);
+        values.push_back(i);
+    }
+    base::InstrumentedTree<int> tree(values.begin(), values.end());
+    tree.resetStatistics();
+
+    EXPECT_EQ(2u, tree.erase(7));
+    EXPECT_EQ(0u, tree.erase(1000));
+    EXPECT_EQ(2u, tree.getStatistics().erases);
+
+    tree.erase(tree.lower_bound(10), tree.lower_bound(20));
+    EXPECT_EQ(22u, tree.getStatistics().erases);
+
+    base::InstrumentedTree<int> other;
+    for (int i = 50; i < 60; ++i) other.insert(i);
+    tree.subtract(other);
+    EXPECT_EQ(42u, tree.getStatistics().erases);
+
+    tree.erase(tree.begin(), tree.end());
+    EXPECT_EQ(200u, tree.getStatistics().erases);
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(UT025TreeStatistics, ParallelMerge_RunsOnCallingThreadAndCounts) {
+    base::ThreadPool pool(2);
+    std::vector<int> values;
+    for (int i = 0; i < 20000; ++i) values.push_back(i);
+    base::InstrumentedTree<int> tree(values.begin(), values.end());
+    tree.resetStatistics();
+
+    tree.insert(values.begin(), values.end(), pool);
+
+    EXPECT_EQ(40000u, tree.size());
+    EXPECT_LT(0u, tree.getStatistics().comparisons);
+}
+
+TEST(UT025TreeStatistics, StreamOutput_ListsCountersAndDepths) {
+    base::InstrumentedTree<int> tree;
+    tree.insert(2);
+    tree.insert(1);
+    tree.contains(1);
+    std::ostringstream out;
+
+    out << tree.getStatistics();
+
+    EXPECT_NE(std::string::npos, out.str().find("Inserts: 2"));
+    EXPECT_NE(std::string::npos, out.str().find("lookups: 1"));
+    EXPECT_NE(std::string::npos, out.str().find(" 2:1"));
+}